@@ -1,11 +1,15 @@
 #pragma once
 #include <iostream>
 #include <fstream>
+#include <atomic>
+#include <mutex>
 #include <vector>
 #include <algorithm> // Добавлен для std::min/max
 
 #include "../Models/Move.h"
 #include "../Models/Project_path.h"
+#include "../Models/UndoLog.h"
+#include "Logger.h"
 
 // Условная компиляция для подключения SDL2:
 // macOS использует иную структуру каталогов для заголовков SDL2.
@@ -19,6 +23,23 @@
 
 using namespace std;
 
+/**
+ * @brief Неизменяемый снимок того, что нужно показать: шашки, подсветка, выбор и результат игры.
+ * Поток игры публикует снимки, поток отрисовки рисует последний из них.
+ */
+struct BoardSnapshot
+{
+    vector<vector<POS_T>> mtx;
+    vector<vector<bool>> highlighted;
+    int active_x = -1, active_y = -1;
+    int game_results = -1;
+};
+
+/**
+ * @brief Доска: состояние партии (меняется потоком игры) и ее отрисовка (в главном потоке, владеющем окном SDL).
+ * Изменения состояния не рисуют сами, а только публикуют снимок и будят главный поток; тот рисует
+ * последний снимок с частотой кадров дисплея (vsync), объединяя несколько изменений в один кадр.
+ */
 class Board
 {
 public:
@@ -35,7 +56,7 @@ public:
     // draws start board
     /**
      * @brief Инициализирует графическую подсистему (SDL), создает окно/рендерер
-     * и загружает все текстуры.
+     * и загружает все текстуры. Вызывается в главном потоке до запуска потока игры.
      * @return int: 0 в случае успеха, 1 в случае ошибки инициализации/загрузки.
      */
     int start_draw()
@@ -68,13 +89,15 @@ public:
             return 1;
         }
         // Создание рендерера с аппаратным ускорением и вертикальной синхронизацией.
-        ren = SDL_CreateRenderer(win, -1, SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC);
+        // Рендеринг в текстуру нужен для кадра, в котором перерисовываются только изменившиеся клетки.
+        ren = SDL_CreateRenderer(win, -1,
+                                 SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC | SDL_RENDERER_TARGETTEXTURE);
         if (ren == nullptr)
         {
             print_exception("SDL_CreateRenderer can't create renderer");
             return 1;
         }
-        // Загрузка всех необходимых текстур (доска, шашки, дамки, кнопки).
+        // Загрузка всех необходимых текстур (доска, шашки, дамки, кнопки, результаты игры).
         board = IMG_LoadTexture(ren, board_path.c_str());
         w_piece = IMG_LoadTexture(ren, piece_white_path.c_str());
         b_piece = IMG_LoadTexture(ren, piece_black_path.c_str());
@@ -82,16 +105,24 @@ public:
         b_queen = IMG_LoadTexture(ren, queen_black_path.c_str());
         back = IMG_LoadTexture(ren, back_path.c_str());
         replay = IMG_LoadTexture(ren, replay_path.c_str());
-        if (!board || !w_piece || !b_piece || !w_queen || !b_queen || !back || !replay)
+        // Индекс в results - код результата игры (0 - ничья, 1 - победа белых, 2 - победа черных).
+        results[0] = IMG_LoadTexture(ren, draw_path.c_str());
+        results[1] = IMG_LoadTexture(ren, white_path.c_str());
+        results[2] = IMG_LoadTexture(ren, black_path.c_str());
+        if (!board || !w_piece || !b_piece || !w_queen || !b_queen || !back || !replay || !results[0] ||
+            !results[1] || !results[2])
         {
             print_exception("IMG_LoadTexture can't load main textures from " + textures_path);
             return 1;
         }
         // Перечитываем актуальные размеры после создания рендерера.
         SDL_GetRendererOutputSize(ren, &W, &H);
+        make_frame();
+        redraw_event = SDL_RegisterEvents(1);
         // Инициализация игрового поля и его отрисовка.
         make_start_mtx();
-        rerender();
+        publish();
+        present();
         return 0;
     }
 
@@ -101,9 +132,7 @@ public:
     void redraw()
     {
         game_results = -1; // Сброс флага результата игры.
-        history_mtx.clear(); // Очистка истории состояний доски.
-        history_beat_series.clear(); // Очистка истории серий взятий.
-        make_start_mtx(); // Установка начальной расстановки шашек.
+        make_start_mtx(); // Установка начальной расстановки шашек (и новый журнал ходов).
         clear_active(); // Сброс активной (выбранной) шашки.
         clear_highlight(); // Сброс подсвеченных клеток.
     }
@@ -117,11 +146,7 @@ public:
      */
     void move_piece(move_pos turn, const int beat_series = 0)
     {
-        if (turn.xb != -1) // Если есть битая шашка (координаты != -1)
-        {
-            mtx[turn.xb][turn.yb] = 0; // Удаляем битую шашку с доски.
-        }
-        move_piece(turn.x, turn.y, turn.x2, turn.y2, beat_series); // Вызов основного перемещения.
+        make_step(turn.x, turn.y, turn.x2, turn.y2, turn.xb, turn.yb, beat_series);
     }
 
     /**
@@ -134,35 +159,18 @@ public:
      */
     void move_piece(const POS_T i, const POS_T j, const POS_T i2, const POS_T j2, const int beat_series = 0)
     {
-        // Проверка на ошибки: конечная позиция не должна быть занята.
-        if (mtx[i2][j2])
-        {
-            throw runtime_error("final position is not empty, can't move");
-        }
-        // Проверка на ошибки: начальная позиция не должна быть пуста.
-        if (!mtx[i][j])
-        {
-            throw runtime_error("begin position is empty, can't move");
-        }
-        // Проверка и выполнение превращения в дамку:
-        // Белая шашка (1) достигает 0-й строки ИЛИ Черная шашка (2) достигает 7-й строки.
-        if ((mtx[i][j] == 1 && i2 == 0) || (mtx[i][j] == 2 && i2 == 7))
-            mtx[i][j] += 2; // Тип шашки меняется (1->3, 2->4).
-
-        mtx[i2][j2] = mtx[i][j]; // Перемещаем шашку на конечную позицию.
-        drop_piece(i, j); // Очищаем начальную позицию и перерисовываем.
-        add_history(beat_series); // Сохраняем состояние доски в историю.
+        make_step(i, j, i2, j2, -1, -1, beat_series);
     }
 
     /**
-     * @brief Удаляет шашку с заданной позиции и перерисовывает доску.
+     * @brief Удаляет шашку с заданной позиции и публикует новое состояние доски.
      * @param i X-координата.
      * @param j Y-координата.
      */
     void drop_piece(const POS_T i, const POS_T j)
     {
         mtx[i][j] = 0;
-        rerender();
+        publish();
     }
 
     /**
@@ -177,7 +185,7 @@ public:
             throw runtime_error("can't turn into queen in this position");
         }
         mtx[i][j] += 2; // Увеличиваем тип шашки: 1->3, 2->4.
-        rerender();
+        publish();
     }
 
     /**
@@ -202,7 +210,7 @@ public:
             POS_T x = pos.first, y = pos.second;
             is_highlighted_[x][y] = 1; // Устанавливаем флаг подсветки.
         }
-        rerender();
+        publish();
     }
 
     /**
@@ -214,7 +222,7 @@ public:
         {
             is_highlighted_[i].assign(8, 0);
         }
-        rerender();
+        publish();
     }
 
     /**
@@ -226,7 +234,7 @@ public:
     {
         active_x = x;
         active_y = y;
-        rerender();
+        publish();
     }
 
     /**
@@ -236,7 +244,7 @@ public:
     {
         active_x = -1;
         active_y = -1;
-        rerender();
+        publish();
     }
 
     /**
@@ -258,22 +266,22 @@ public:
      */
     void rollback()
     {
-        // Определяем, сколько шагов нужно откатить.
-        // max(1, ...) гарантирует, что даже обычный ход (beat_series=0) откатится на 1 шаг.
-        auto beat_series = max(1, *(history_beat_series.rbegin()));
-
-        // Откатываем все шаги серии, пока не вернемся к предыдущему полному ходу.
-        while (beat_series-- && history_mtx.size() > 1)
-        {
-            history_mtx.pop_back();
-            history_beat_series.pop_back();
-        }
-        // Восстанавливаем состояние доски из истории (последнее сохраненное).
-        mtx = *(history_mtx.rbegin());
+        // Шаги последнего хода отменяются по журналу в обратном порядке (битые шашки возвращаются,
+        // превращение в дамку отменяется), копии доски не нужны.
+        history.undo_turn(mtx);
         clear_highlight();
         clear_active();
     }
 
+    /**
+     * @brief Число сделанных шагов партии (ход без взятия - один шаг, серия взятий - шаг на каждое взятие).
+     * Откатывать можно, пока оно больше нуля.
+     */
+    size_t history_size() const
+    {
+        return history.size();
+    }
+
     /**
      * @brief Устанавливает результат игры для отображения финального экрана.
      * @param res Результат игры (-1: игра продолжается, 0: ничья, 1: победа белых, 2: победа черных).
@@ -281,17 +289,45 @@ public:
     void show_final(const int res)
     {
         game_results = res;
-        rerender();
+        publish();
     }
 
     // use if window size changed
     /**
-     * @brief Обновляет размеры окна и перерисовывает доску после изменения размера окна.
+     * @brief Обновляет размеры окна и перерисовывает доску после изменения размера окна (главный поток).
      */
     void reset_window_size()
     {
         SDL_GetRendererOutputSize(ren, &W, &H);
-        rerender();
+        make_frame(); // Кадр прежнего размера не годится, он рисуется заново целиком.
+        present();
+    }
+
+    /**
+     * @brief Рисует последний опубликованный снимок, если он еще не показан или кадр нужно нарисовать заново.
+     * Вызывается только в главном потоке; ожидание vsync в SDL_RenderPresent задает частоту кадров,
+     * а поток игры при этом не ждет.
+     */
+    void present()
+    {
+        redraw_pending = false; // Следующая публикация снова разбудит главный поток.
+        BoardSnapshot snap;
+        {
+            lock_guard<mutex> lock(snapshot_mutex);
+            if (frame_valid && snapshot_version == drawn_version)
+                return;
+            snap = snapshot;
+            drawn_version = snapshot_version;
+        }
+        render(snap);
+    }
+
+    /**
+     * @brief Тип пользовательского события SDL, которым поток игры будит главный поток для отрисовки.
+     */
+    Uint32 get_redraw_event() const
+    {
+        return redraw_event;
     }
 
     /**
@@ -306,6 +342,10 @@ public:
         SDL_DestroyTexture(b_queen);
         SDL_DestroyTexture(back);
         SDL_DestroyTexture(replay);
+        for (SDL_Texture* result : results)
+            SDL_DestroyTexture(result);
+        SDL_DestroyTexture(background);
+        SDL_DestroyTexture(frame);
         SDL_DestroyRenderer(ren);
         SDL_DestroyWindow(win);
         SDL_Quit();
@@ -322,13 +362,41 @@ public:
 
 private:
     /**
-     * @brief Добавляет текущее состояние доски и информацию о серии взятий в историю.
+     * @brief Выполняет шаг хода (со взятием, если xb != -1), проверяет превращение в дамку и записывает шаг в журнал.
      * @param beat_series Количество взятий в текущей серии.
      */
-    void add_history(const int beat_series = 0)
+    void make_step(const POS_T i, const POS_T j, const POS_T i2, const POS_T j2, const POS_T xb, const POS_T yb,
+                   const int beat_series)
     {
-        history_mtx.push_back(mtx); // Сохранение матрицы доски.
-        history_beat_series.push_back(beat_series); // Сохранение статуса серии взятий.
+        // Проверка на ошибки: конечная позиция не должна быть занята.
+        if (mtx[i2][j2])
+        {
+            throw runtime_error("final position is not empty, can't move");
+        }
+        // Проверка на ошибки: начальная позиция не должна быть пуста.
+        if (!mtx[i][j])
+        {
+            throw runtime_error("begin position is empty, can't move");
+        }
+        POS_T captured = 0;
+        if (xb != -1) // Если есть битая шашка (координаты != -1)
+        {
+            captured = mtx[xb][yb];
+            mtx[xb][yb] = 0; // Удаляем битую шашку с доски.
+        }
+        // Проверка и выполнение превращения в дамку:
+        // Белая шашка (1) достигает 0-й строки ИЛИ Черная шашка (2) достигает 7-й строки.
+        const bool promoted = (mtx[i][j] == 1 && i2 == 0) || (mtx[i][j] == 2 && i2 == 7);
+        if (promoted)
+            mtx[i][j] += 2; // Тип шашки меняется (1->3, 2->4).
+
+        mtx[i2][j2] = mtx[i][j]; // Перемещаем шашку на конечную позицию.
+        mtx[i][j] = 0;
+        // Сохраняем шаг в журнал ходов.
+        history.push(history_step(sq_index(i, j), sq_index(i2, j2), xb != -1 ? sq_index(xb, yb) : -1, captured,
+                                  promoted, beat_series),
+                     mtx);
+        publish();
     }
     // function to make start matrix
     /**
@@ -350,116 +418,210 @@ private:
                     mtx[i][j] = 1;
             }
         }
-        add_history(); // Сохраняем начальное состояние.
+        history.reset(mtx); // Начальная расстановка - первая контрольная точка журнала.
+    }
+
+    /**
+     * @brief Создает текстуры размера окна: фон (доска, растянутая на окно) и кадр, в котором хранится
+     * отрисованная доска. Если рендерер не умеет рисовать в текстуру, кадра нет и доска каждый раз рисуется целиком.
+     */
+    void make_frame()
+    {
+        SDL_DestroyTexture(background);
+        SDL_DestroyTexture(frame);
+        background = frame = nullptr;
+        frame_valid = false;
+        if (!SDL_RenderTargetSupported(ren))
+            return;
+        background = SDL_CreateTexture(ren, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, W, H);
+        frame = SDL_CreateTexture(ren, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, W, H);
+        if (!background || !frame || SDL_SetRenderTarget(ren, background) != 0)
+        {
+            print_exception("SDL_CreateTexture can't create frame texture, the board is redrawn entirely");
+            SDL_DestroyTexture(background);
+            SDL_DestroyTexture(frame);
+            background = frame = nullptr;
+            return;
+        }
+        SDL_RenderCopy(ren, board, NULL, NULL);
+        SDL_SetRenderTarget(ren, NULL);
+    }
+
+    /**
+     * @brief Публикует текущее состояние доски для отрисовки и будит главный поток (поток игры).
+     * Пока главный поток не нарисовал предыдущий снимок, новое событие не посылается: кадр покажет последний снимок.
+     */
+    void publish()
+    {
+        {
+            lock_guard<mutex> lock(snapshot_mutex);
+            snapshot.mtx = mtx;
+            snapshot.highlighted = is_highlighted_;
+            snapshot.active_x = active_x;
+            snapshot.active_y = active_y;
+            snapshot.game_results = game_results;
+            ++snapshot_version;
+        }
+        if (redraw_event != Uint32(-1) && !redraw_pending.exchange(true))
+        {
+            SDL_Event event{};
+            event.type = redraw_event;
+            SDL_PushEvent(&event);
+        }
     }
 
     // function that re-draw all the textures
     /**
-     * @brief Главная функция отрисовки. Полностью перерисовывает все элементы на экране.
+     * @brief Главная функция отрисовки (главный поток). Доска хранится в кадре (frame), в нем перерисовываются
+     * только клетки, у которых с прошлого кадра изменились шашка, подсветка или выбор; затем кадр и результат игры
+     * выводятся на экран.
+     * @param snap Снимок, который нужно показать.
      */
-    void rerender()
+    void render(const BoardSnapshot& snap)
+    {
+        if (frame)
+        {
+            SDL_SetRenderTarget(ren, frame);
+            if (!frame_valid)
+                draw_board(snap);
+            else
+                draw_changed_cells(snap);
+            SDL_SetRenderTarget(ren, NULL);
+            SDL_RenderCopy(ren, frame, NULL, NULL); // Копирование готового кадра на экран.
+        }
+        else
+        {
+            SDL_RenderClear(ren); // Очистка рендерера.
+            draw_board(snap);
+        }
+
+        // Результат (финальный экран) рисуется поверх кадра и в кадр не попадает.
+        if (snap.game_results != -1) // Если игра завершена.
+        {
+            SDL_Rect res_rect{ W / 5, H * 3 / 10, W * 3 / 5, H * 2 / 5 };
+            SDL_RenderCopy(ren, results[snap.game_results], NULL, &res_rect); // Отрисовка финального экрана.
+        }
+
+        SDL_RenderPresent(ren); // Вывод отрисованного кадра на экран (ждет vsync).
+    }
+
+    /**
+     * @brief Рисует всю доску: фон, шашки, подсветку, выбор и кнопки "Отменить" и "Перезапуск".
+     */
+    void draw_board(const BoardSnapshot& snap)
     {
         // 1. draw board
-        SDL_RenderClear(ren); // Очистка рендерера.
         SDL_RenderCopy(ren, board, NULL, NULL); // Отрисовка текстуры доски на весь экран.
 
-        // 2. draw pieces
+        // 2-4. draw pieces, hilight and active
         for (POS_T i = 0; i < 8; ++i)
         {
             for (POS_T j = 0; j < 8; ++j)
-            {
-                if (!mtx[i][j])
-                    continue;
-                // Вычисление координат для отрисовки шашки.
-                int wpos = W * (j + 1) / 10 + W / 120; // x-координата на экране.
-                int hpos = H * (i + 1) / 10 + H / 120; // y-координата на экране.
-                SDL_Rect rect{ wpos, hpos, W / 12, H / 12 }; // Целевой прямоугольник.
-
-                SDL_Texture* piece_texture;
-                // Выбор текстуры в зависимости от типа шашки (1-белая, 2-черная, 3-белая дамка, 4-черная дамка).
-                if (mtx[i][j] == 1)
-                    piece_texture = w_piece;
-                else if (mtx[i][j] == 2)
-                    piece_texture = b_piece;
-                else if (mtx[i][j] == 3)
-                    piece_texture = w_queen;
-                else
-                    piece_texture = b_queen;
-
-                SDL_RenderCopy(ren, piece_texture, NULL, &rect); // Отрисовка шашки.
-            }
+                draw_cell_content(snap, i, j);
         }
 
-        // 3. draw hilight
-        SDL_SetRenderDrawColor(ren, 0, 255, 0, 0); // Установка зеленого цвета для подсветки.
-        const double scale = 2.5; // Коэффициент для уменьшения толщины рамки подсветки.
-        SDL_RenderSetScale(ren, scale, scale); // Установка масштаба для отрисовки тонких линий.
+        // 5. draw arrows (кнопки "Отменить" и "Перезапуск")
+        SDL_Rect rect_left{ W / 40, H / 40, W / 15, H / 15 };
+        SDL_RenderCopy(ren, back, NULL, &rect_left);
+        SDL_Rect replay_rect{ W * 109 / 120, H / 40, W / 15, H / 15 };
+        SDL_RenderCopy(ren, replay, NULL, &replay_rect);
+        drawn = snap;
+        frame_valid = true;
+    }
+
+    /**
+     * @brief Перерисовывает в кадре только клетки, изменившиеся с прошлой отрисовки.
+     */
+    void draw_changed_cells(const BoardSnapshot& snap)
+    {
         for (POS_T i = 0; i < 8; ++i)
         {
             for (POS_T j = 0; j < 8; ++j)
             {
-                if (!is_highlighted_[i][j])
+                const bool was_active = (i == drawn.active_x && j == drawn.active_y);
+                const bool is_active = (i == snap.active_x && j == snap.active_y);
+                if (snap.mtx[i][j] == drawn.mtx[i][j] && snap.highlighted[i][j] == drawn.highlighted[i][j] &&
+                    was_active == is_active)
                     continue;
-                // Вычисление прямоугольника для подсвеченной клетки (с учетом масштаба).
-                SDL_Rect cell{ int(W * (j + 1) / 10 / scale), int(H * (i + 1) / 10 / scale), int(W / 10 / scale),
-                              int(H / 10 / scale) };
-                SDL_RenderDrawRect(ren, &cell); // Отрисовка рамки.
+                // Клетка закрашивается фоном, затем на ней рисуется новое содержимое.
+                const SDL_Rect rect = cell_rect(i, j);
+                SDL_RenderCopy(ren, background, &rect, &rect);
+                draw_cell_content(snap, i, j);
             }
         }
+        drawn = snap;
+        frame_valid = true;
+    }
 
-        // 4. draw active
-        if (active_x != -1) // Если есть активная шашка.
+    /**
+     * @brief Рисует содержимое клетки поверх фона: шашку, рамку подсветки и рамку выбора.
+     * Все рисуется внутри прямоугольника клетки, поэтому соседние клетки не затрагиваются.
+     */
+    void draw_cell_content(const BoardSnapshot& snap, const POS_T i, const POS_T j)
+    {
+        const auto& mtx = snap.mtx;
+        if (mtx[i][j])
         {
-            SDL_SetRenderDrawColor(ren, 255, 0, 0, 0); // Установка красного цвета для активной шашки.
-            // Вычисление прямоугольника для активной клетки.
-            SDL_Rect active_cell{ int(W * (active_y + 1) / 10 / scale), int(H * (active_x + 1) / 10 / scale),
-                                 int(W / 10 / scale), int(H / 10 / scale) };
-            SDL_RenderDrawRect(ren, &active_cell); // Отрисовка рамки.
+            // Вычисление координат для отрисовки шашки.
+            int wpos = W * (j + 1) / 10 + W / 120; // x-координата на экране.
+            int hpos = H * (i + 1) / 10 + H / 120; // y-координата на экране.
+            SDL_Rect rect{ wpos, hpos, W / 12, H / 12 }; // Целевой прямоугольник.
+
+            SDL_Texture* piece_texture;
+            // Выбор текстуры в зависимости от типа шашки (1-белая, 2-черная, 3-белая дамка, 4-черная дамка).
+            if (mtx[i][j] == 1)
+                piece_texture = w_piece;
+            else if (mtx[i][j] == 2)
+                piece_texture = b_piece;
+            else if (mtx[i][j] == 3)
+                piece_texture = w_queen;
+            else
+                piece_texture = b_queen;
+
+            SDL_RenderCopy(ren, piece_texture, NULL, &rect); // Отрисовка шашки.
         }
-        SDL_RenderSetScale(ren, 1, 1); // Сброс масштаба.
-
-        // 5. draw arrows (кнопки "Отменить" и "Перезапуск")
-        SDL_Rect rect_left{ W / 40, H / 40, W / 15, H / 15 };
-        SDL_RenderCopy(ren, back, NULL, &rect_left);
-        SDL_Rect replay_rect{ W * 109 / 120, H / 40, W / 15, H / 15 };
-        SDL_RenderCopy(ren, replay, NULL, &replay_rect);
-
-        // 6. draw result (финальный экран)
-        if (game_results != -1) // Если игра завершена.
+        if (snap.highlighted[i][j])
         {
-            string result_path = draw_path;
-            if (game_results == 1) // 1: победа белых.
-                result_path = white_path;
-            else if (game_results == 2) // 2: победа черных.
-                result_path = black_path;
-            // Загрузка текстуры с результатом (победа/ничья).
-            SDL_Texture* result_texture = IMG_LoadTexture(ren, result_path.c_str());
-            if (result_texture == nullptr)
-            {
-                print_exception("IMG_LoadTexture can't load game result picture from " + result_path);
-                return;
-            }
-            SDL_Rect res_rect{ W / 5, H * 3 / 10, W * 3 / 5, H * 2 / 5 };
-            SDL_RenderCopy(ren, result_texture, NULL, &res_rect); // Отрисовка финального экрана.
-            SDL_DestroyTexture(result_texture); // Освобождение временной текстуры.
+            SDL_SetRenderDrawColor(ren, 0, 255, 0, 0); // Зеленая рамка для подсветки.
+            draw_frame(cell_rect(i, j));
+        }
+        if (i == snap.active_x && j == snap.active_y)
+        {
+            SDL_SetRenderDrawColor(ren, 255, 0, 0, 0); // Красная рамка для активной шашки.
+            draw_frame(cell_rect(i, j));
         }
+    }
+
+    /**
+     * @brief Рисует рамку по внутреннему краю прямоугольника текущим цветом.
+     */
+    void draw_frame(const SDL_Rect& rect)
+    {
+        const int t = 3; // Толщина рамки в пикселях.
+        const SDL_Rect sides[4] = { { rect.x, rect.y, rect.w, t },
+                                    { rect.x, rect.y + rect.h - t, rect.w, t },
+                                    { rect.x, rect.y, t, rect.h },
+                                    { rect.x + rect.w - t, rect.y, t, rect.h } };
+        for (const SDL_Rect& side : sides)
+            SDL_RenderFillRect(ren, &side);
+    }
 
-        SDL_RenderPresent(ren); // Вывод отрисованного кадра на экран.
-        // next rows for mac os
-        // Небольшая задержка и обработка событий для корректного отображения на macOS.
-        SDL_Delay(10);
-        SDL_Event windowEvent;
-        SDL_PollEvent(&windowEvent);
+    /**
+     * @brief Прямоугольник клетки (i, j) на экране; соседние клетки не пересекаются.
+     */
+    SDL_Rect cell_rect(const POS_T i, const POS_T j) const
+    {
+        const int x = W * (j + 1) / 10, y = H * (i + 1) / 10;
+        return { x, y, W * (j + 2) / 10 - x, H * (i + 2) / 10 - y };
     }
 
     /**
-     * @brief Записывает сообщение об ошибке в файл журнала (log.txt).
+     * @brief Записывает сообщение об ошибке в журнал (log.txt).
      * @param text Сообщение об ошибке.
      */
     void print_exception(const string& text) {
-        ofstream fout(project_path + "log.txt", ios_base::app); // Открытие файла в режиме добавления.
-        fout << "Error: " << text << ". " << SDL_GetError() << endl; // Запись ошибки SDL.
-        fout.close();
+        // Запись ошибки вместе с ошибкой SDL.
+        logger().write(LogLine(LogLevel::Error, "error").field("message", text).field("sdl_error", SDL_GetError()));
     }
 
 public:
@@ -471,11 +633,6 @@ public:
      * @brief Высота окна (публичное поле).
      */
     int H = 0;
-    // history of boards
-    /**
-     * @brief История состояний доски. Вектор векторов матриц.
-     */
-    vector<vector<vector<POS_T>>> history_mtx;
 
 private:
     /**
@@ -494,6 +651,20 @@ private:
     SDL_Texture* b_queen = nullptr;
     SDL_Texture* back = nullptr;
     SDL_Texture* replay = nullptr;
+    SDL_Texture* results[3] = { nullptr, nullptr, nullptr }; // ничья, победа белых, победа черных
+    // Текстуры размера окна: доска, растянутая на окно, и кадр с последней отрисованной доской.
+    SDL_Texture* background = nullptr;
+    SDL_Texture* frame = nullptr;
+    // Что нарисовано в кадре (для поиска изменившихся клеток); frame_valid = false - кадр рисуется заново.
+    bool frame_valid = false;
+    BoardSnapshot drawn;
+    // Последний опубликованный снимок и номера версий: опубликованной и нарисованной.
+    mutex snapshot_mutex;
+    BoardSnapshot snapshot;
+    uint64_t snapshot_version = 0, drawn_version = 0;
+    // Событие "пора рисовать" уже в очереди SDL (не посылать повторно).
+    atomic<bool> redraw_pending{false};
+    Uint32 redraw_event = Uint32(-1);
     // texture files names (Пути к файлам текстур)
     const string textures_path = project_path + "Textures/";
     const string board_path = textures_path + "board.png";
@@ -527,10 +698,9 @@ private:
      * @brief Матрица текущего состояния доски: 0 - пусто, 1-4 - типы шашек.
      */
     vector<vector<POS_T>> mtx = vector<vector<POS_T>>(8, vector<POS_T>(8, 0));
-    // series of beats for each move
+    // history of moves
     /**
-     * @brief История серий взятий: количество взятий, выполненных в последнем шаге.
-     * Используется для корректного отката хода.
+     * @brief Журнал ходов партии: упакованные шаги с битыми фигурами и превращениями (для отката хода).
      */
-    vector<int> history_beat_series;
+    UndoLog history;
 };
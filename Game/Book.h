@@ -0,0 +1,102 @@
+#pragma once
+#include <stdint.h>
+#include <string.h>
+#include <string>
+
+#include "../Models/Position.h"
+#include "MappedFile.h"
+
+// Формат файла книги дебютов: заголовок, затем записи BookEntry, отсортированные по (key, move, beaten).
+struct BookHeader
+{
+    char magic[4];    // "CBK1"
+    uint32_t entries; // число записей после заголовка
+};
+
+struct BookEntry
+{
+    uint64_t key;     // ключ позиции: хэш расстановки и сторона, которая ходит (position_key)
+    uint32_t beaten;  // битые за ход фигуры (вместе с move опознает полный ход)
+    uint16_t move;    // упакованный move_code полного хода
+    uint16_t reserved;
+    uint32_t games;   // сколько раз ход сыгран в партиях построения
+    uint32_t score;   // очки за эти партии с точки зрения сделавшего ход: 2 за победу, 1 за ничью
+
+    bool operator<(const BookEntry& other) const
+    {
+        if (key != other.key)
+            return key < other.key;
+        if (move != other.move)
+            return move < other.move;
+        return beaten < other.beaten;
+    }
+};
+
+/**
+ * @brief Книга дебютов (строится Tools/book_gen), отображенная в память только для чтения.
+ * Поиск позиции - двоичный поиск по отсортированным записям.
+ */
+class Book
+{
+public:
+    Book() = default;
+
+    /**
+     * @brief Открывает файл книги; если файла нет или он поврежден, книга остается пустой.
+     */
+    explicit Book(const std::string& path)
+    {
+        if (!path.empty() && file.map(path) && !read_header())
+            file.unmap();
+    }
+
+    Book(const Book&) = delete;
+    Book& operator=(const Book&) = delete;
+
+    /**
+     * @brief Записи позиции.
+     * @param key Ключ позиции (position_key).
+     * @param first Сюда записывается первая запись позиции.
+     * @return size_t Число записей позиции (0 - позиции нет в книге).
+     */
+    size_t probe(const uint64_t key, const BookEntry*& first) const
+    {
+        size_t lo = 0, hi = count;
+        while (lo < hi)
+        {
+            const size_t mid = (lo + hi) / 2;
+            if (entries[mid].key < key)
+                lo = mid + 1;
+            else
+                hi = mid;
+        }
+        first = entries + lo;
+        size_t n = 0;
+        while (lo + n < count && entries[lo + n].key == key)
+            ++n;
+        return n;
+    }
+
+private:
+    /**
+     * @brief Проверяет заголовок и размер файла.
+     */
+    bool read_header()
+    {
+        BookHeader header;
+        if (file.size() < sizeof(header))
+            return false;
+        memcpy(&header, file.data(), sizeof(header));
+        if (memcmp(header.magic, "CBK1", 4) != 0 ||
+            file.size() != sizeof(header) + uint64_t(header.entries) * sizeof(BookEntry))
+            return false;
+        // Заголовок занимает 8 байт, так что записи в отображении выровнены.
+        entries = reinterpret_cast<const BookEntry*>(file.data() + sizeof(header));
+        count = header.entries;
+        return true;
+    }
+
+    MappedFile file;
+    const BookEntry* entries = nullptr;
+    size_t count = 0;
+};
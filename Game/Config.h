@@ -1,45 +1,353 @@
 #pragma once
-#include <fstream>//     ( ).
-#include <nlohmann/json.hpp>//     JSON.
+#include <atomic>
+#include <chrono>
+#include <fstream>// Для работы с файлами (чтение настроек).
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <nlohmann/json.hpp>// Сторонняя библиотека для парсинга JSON.
 using json = nlohmann::json;
 
-#include "../Models/Project_path.h"//        .
+#ifdef __linux__
+#include <poll.h>
+#include <string.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#else
+#include <filesystem>
+#endif
 
-//  Config            settings.json.
+#include "../Models/Project_path.h"// Глобальный путь к проекту для доступа к файлам.
+#include "Logger.h"
+
+// Режим оценки позиции ("BotScoringType").
+enum class Scoring
+{
+    NumberOnly,        // только число шашек и дамок
+    NumberAndPotential // плюс продвижение шашек к превращению
+};
+
+// Режим оптимизации поиска ("Optimization").
+enum class Optimization
+{
+    O0, // полный перебор без отсечений и таблицы транспозиций
+    O1, // alpha-beta отсечения и таблица транспозиций
+    O2  // плюс поиск с нулевым окном (PVS), окно вокруг оценки прошлой итерации и сокращение поздних ходов
+};
+
+/**
+ * @brief Настройки из settings.json, разобранные и проверенные при загрузке.
+ * Снимок неизменяем: перезагрузка создает новый снимок, а читатели продолжают работать со старым.
+ * Значения по умолчанию используются для настроек, которых нет в файле.
+ */
+struct Settings
+{
+    // WindowSize
+    int window_width = 0;  // "Width", 0 - по размеру экрана
+    int window_height = 0; // "Hight", 0 - по размеру экрана
+    // Bot (индекс массивов - цвет: 0 - белые, 1 - черные)
+    bool is_bot[2] = { false, true };  // "IsWhiteBot", "IsBlackBot"
+    int bot_level[2] = { 0, 5 };       // "WhiteBotLevel", "BlackBotLevel"
+    Scoring scoring = Scoring::NumberAndPotential;
+    int bot_delay_ms = 0;
+    int bot_time_ms = 0;
+    bool no_random = false;
+    Optimization optimization = Optimization::O1;
+    int hash_size_mb = 64;
+    int bot_threads = 1;
+    int quiescence_nodes = 256;
+    std::string tablebase_file = "tablebase.bin";
+    std::string book_file = "book.bin";
+    bool ponder = true;
+    // Game
+    int max_num_turns = 120;
+    LogLevel log_level = LogLevel::Info; // "LogLevel"
+};
+
+// Класс Config отвечает за загрузку и предоставление доступа к настройкам игры из файла settings.json.
+// Настройки читаются через get() - неизменяемый снимок Settings, который заменяется атомарно
+// при перезагрузке (в том числе при изменении файла во время игры, см. watch()).
 class Config
 {
 public:
-    // :   reload()      .
+    // Конструктор: загружает настройки; ошибки в файле сообщаются сразу, а не посреди партии.
     Config()
     {
-        reload();
+        std::string error;
+        if (!reload(&error))
+            throw std::runtime_error(error);
+    }
+
+    Config(const Config&) = delete;
+    Config& operator=(const Config&) = delete;
+
+    ~Config()
+    {
+        stop_watch = true;
+        if (watcher.joinable())
+            watcher.join();
+    }
+
+    /**
+     * @brief Перезагружает настройки из файла settings.json.
+     * Если файл не читается или значение неверно, остаются прежние настройки.
+     * @param error Сюда записывается описание ошибки.
+     * @return bool: true, если новые настройки загружены.
+     */
+    bool reload(std::string* error = nullptr)
+    {
+        json loaded;
+        try
+        {
+            // Открытие файла настроек. project_path - это путь к корневой папке проекта.
+            std::ifstream fin(settings_path());
+            if (!fin)
+                throw std::runtime_error("can't open file");
+            // Парсинг содержимого файла в объект JSON с помощью nlohmann/json.
+            fin >> loaded;
+        }
+        catch (const std::exception& e)
+        {
+            if (error)
+                *error = settings_path() + ": " + e.what();
+            return false;
+        }
+        std::lock_guard<std::mutex> lock(json_mutex);
+        return apply(loaded, error);
+    }
+
+    /**
+     * @brief Текущий снимок настроек. Снимок не меняется, поэтому его можно читать из любого потока
+     * и держать, пока нужны согласованные значения (например, в течение одного хода).
+     */
+    std::shared_ptr<const Settings> get() const
+    {
+        return std::atomic_load(&current);
+    }
+
+    /**
+     * @brief Заменяет значение настройки в памяти (файл не меняется; reload() вернет значение из файла).
+     * Нужен инструментам, которые играют с настройками, отличными от settings.json.
+     * @throw std::invalid_argument Если значение неверно (настройки не меняются).
+     */
+    void set(const std::string& setting_dir, const std::string& setting_name, const json& value)
+    {
+        std::lock_guard<std::mutex> lock(json_mutex);
+        json changed = config;
+        changed[setting_dir][setting_name] = value;
+        std::string error;
+        if (!apply(changed, &error))
+            throw std::invalid_argument(error);
     }
 
     /**
-     * @brief     settings.json  .
+     * @brief Начинает следить за settings.json: после каждого сохранения файла настройки перезагружаются,
+     * так что уровни ботов и бюджеты времени меняются без перезапуска. Ошибки пишутся в log.txt,
+     * прежние настройки при этом остаются. В Linux используется inotify, в других системах - проверка
+     * времени изменения файла раз в полсекунды.
      */
-    void reload()
+    void watch()
     {
-        //   . project_path -      .
-        std::ifstream fin(project_path + "settings.json");
-        //      JSON   nlohmann/json.
-        fin >> config;
-        fin.close();
+        if (!watcher.joinable())
+            watcher = std::thread(&Config::watch_loop, this);
     }
 
     /**
-     * @brief    '()'     .
-     *      config("", "").
-     * @param setting_dir   (   JSON).
-     * @param setting_name   (   JSON).
-     * @return auto:    (  int, bool, string  ..).
+     * @brief Перезагрузка с записью результата в журнал (после изменения файла и при перезапуске партии).
+     * При ошибке остаются прежние настройки, а ошибка пишется в log.txt.
      */
-    auto operator()(const string& setting_dir, const string& setting_name) const
+    void reload_logged()
     {
-        //    JSON-  .
-        return config[setting_dir][setting_name];
+        std::string error;
+        if (reload(&error))
+        {
+            logger().set_level(get()->log_level);
+            logger().write(LogLine(LogLevel::Info, "settings_reloaded"));
+        }
+        else
+            logger().write(LogLine(LogLevel::Warning, "settings_error").field("message", error));
     }
 
 private:
-    json config;//  ,      JSON-.
-};
\ No newline at end of file
+    static std::string settings_path()
+    {
+        return project_path + "settings.json";
+    }
+
+    /**
+     * @brief Разбирает и проверяет настройки; при успехе публикует новый снимок (json_mutex захвачен).
+     */
+    bool apply(const json& loaded, std::string* error)
+    {
+        auto settings = std::make_shared<Settings>();
+        try
+        {
+            if (!loaded.is_object())
+                throw std::runtime_error("settings must be a JSON object");
+            read_int(loaded, "WindowSize", "Width", 0, 1 << 16, settings->window_width);
+            read_int(loaded, "WindowSize", "Hight", 0, 1 << 16, settings->window_height);
+            read_bool(loaded, "Bot", "IsWhiteBot", settings->is_bot[0]);
+            read_bool(loaded, "Bot", "IsBlackBot", settings->is_bot[1]);
+            read_int(loaded, "Bot", "WhiteBotLevel", 0, 60, settings->bot_level[0]);
+            read_int(loaded, "Bot", "BlackBotLevel", 0, 60, settings->bot_level[1]);
+            std::string name;
+            if (read_string(loaded, "Bot", "BotScoringType", name))
+            {
+                if (name == "NumberOnly")
+                    settings->scoring = Scoring::NumberOnly;
+                else if (name == "NumberAndPotential")
+                    settings->scoring = Scoring::NumberAndPotential;
+                else
+                    throw std::runtime_error("Bot.BotScoringType must be \"NumberOnly\" or \"NumberAndPotential\"");
+            }
+            read_int(loaded, "Bot", "BotDelayMS", 0, 600000, settings->bot_delay_ms);
+            read_int(loaded, "Bot", "BotTimeMS", 0, 3600000, settings->bot_time_ms);
+            read_bool(loaded, "Bot", "NoRandom", settings->no_random);
+            if (read_string(loaded, "Bot", "Optimization", name))
+            {
+                if (name == "O0")
+                    settings->optimization = Optimization::O0;
+                else if (name == "O1")
+                    settings->optimization = Optimization::O1;
+                else if (name == "O2")
+                    settings->optimization = Optimization::O2;
+                else
+                    throw std::runtime_error("Bot.Optimization must be \"O0\", \"O1\" or \"O2\"");
+            }
+            read_int(loaded, "Bot", "HashSizeMB", 0, 1 << 16, settings->hash_size_mb);
+            read_int(loaded, "Bot", "BotThreads", 0, 1024, settings->bot_threads);
+            read_int(loaded, "Bot", "QuiescenceNodes", 0, 1 << 24, settings->quiescence_nodes);
+            read_string(loaded, "Bot", "TablebaseFile", settings->tablebase_file);
+            read_string(loaded, "Bot", "BookFile", settings->book_file);
+            read_bool(loaded, "Bot", "Ponder", settings->ponder);
+            read_int(loaded, "Game", "MaxNumTurns", 1, 100000, settings->max_num_turns);
+            if (read_string(loaded, "Game", "LogLevel", name))
+            {
+                if (name == "debug")
+                    settings->log_level = LogLevel::Debug;
+                else if (name == "info")
+                    settings->log_level = LogLevel::Info;
+                else if (name == "warning")
+                    settings->log_level = LogLevel::Warning;
+                else if (name == "error")
+                    settings->log_level = LogLevel::Error;
+                else if (name == "off")
+                    settings->log_level = LogLevel::Off;
+                else
+                    throw std::runtime_error(
+                        "Game.LogLevel must be \"debug\", \"info\", \"warning\", \"error\" or \"off\"");
+            }
+        }
+        catch (const std::exception& e)
+        {
+            if (error)
+                *error = settings_path() + ": " + e.what();
+            return false;
+        }
+        config = loaded;
+        std::atomic_store(&current, std::shared_ptr<const Settings>(settings));
+        return true;
+    }
+
+    /**
+     * @brief Значение настройки или nullptr, если ее нет в файле.
+     */
+    static const json* find(const json& loaded, const char* dir, const char* name)
+    {
+        if (!loaded.contains(dir))
+            return nullptr;
+        const json& section = loaded[dir];
+        if (!section.is_object())
+            throw std::runtime_error(std::string(dir) + " must be an object");
+        return section.contains(name) ? &section[name] : nullptr;
+    }
+
+    static void read_int(const json& loaded, const char* dir, const char* name, const int lo, const int hi,
+                         int& value)
+    {
+        const json* item = find(loaded, dir, name);
+        if (!item)
+            return;
+        if (!item->is_number_integer() || item->get<long long>() < lo || item->get<long long>() > hi)
+            throw std::runtime_error(std::string(dir) + "." + name + " must be an integer from " +
+                                     std::to_string(lo) + " to " + std::to_string(hi));
+        value = int(item->get<long long>());
+    }
+
+    static void read_bool(const json& loaded, const char* dir, const char* name, bool& value)
+    {
+        const json* item = find(loaded, dir, name);
+        if (!item)
+            return;
+        if (!item->is_boolean())
+            throw std::runtime_error(std::string(dir) + "." + name + " must be true or false");
+        value = item->get<bool>();
+    }
+
+    static bool read_string(const json& loaded, const char* dir, const char* name, std::string& value)
+    {
+        const json* item = find(loaded, dir, name);
+        if (!item)
+            return false;
+        if (!item->is_string())
+            throw std::runtime_error(std::string(dir) + "." + name + " must be a string");
+        value = item->get<std::string>();
+        return true;
+    }
+
+    void watch_loop()
+    {
+#ifdef __linux__
+        // Следим за каталогом, а не за файлом: редакторы часто сохраняют файл заменой (новый файл и rename).
+        const int fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if (fd < 0)
+            return;
+        const std::string dir = project_path.empty() ? std::string(".") : project_path;
+        if (inotify_add_watch(fd, dir.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO) < 0)
+        {
+            close(fd);
+            return;
+        }
+        alignas(inotify_event) char buf[4096];
+        while (!stop_watch)
+        {
+            pollfd pfd{ fd, POLLIN, 0 };
+            if (poll(&pfd, 1, 200) <= 0) // Таймаут нужен, чтобы заметить stop_watch.
+                continue;
+            const ssize_t len = read(fd, buf, sizeof(buf));
+            bool changed = false;
+            for (ssize_t pos = 0; pos < len;)
+            {
+                const inotify_event* event = reinterpret_cast<const inotify_event*>(buf + pos);
+                if (event->len && strcmp(event->name, "settings.json") == 0)
+                    changed = true;
+                pos += sizeof(inotify_event) + event->len;
+            }
+            if (changed)
+                reload_logged();
+        }
+        close(fd);
+#else
+        std::error_code ec;
+        auto last = std::filesystem::last_write_time(settings_path(), ec);
+        while (!stop_watch)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(500));
+            const auto time = std::filesystem::last_write_time(settings_path(), ec);
+            if (!ec && time != last)
+            {
+                last = time;
+                reload_logged();
+            }
+        }
+#endif
+    }
+
+    json config;// Последние загруженные настройки в виде JSON (нужны set()).
+    std::mutex json_mutex;
+    std::shared_ptr<const Settings> current;// Текущий снимок; читается и заменяется атомарно.
+    std::thread watcher;
+    std::atomic<bool> stop_watch{ false };
+};
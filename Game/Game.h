@@ -1,64 +1,118 @@
 #pragma once
+#include <atomic>
 #include <chrono>
 #include <thread>
-#include <fstream> // Добавлен, т.к. используется ofstream
 
 #include "../Models/Project_path.h"
 #include "Board.h"
 #include "Config.h"
 #include "Hand.h"
 #include "Logic.h"
+#include "Ponder.h"
 
 class Game
 {
 public:
-    Game() : board(config("WindowSize", "Width"), config("WindowSize", "Hight")), hand(&board), logic(&board, &config)
+    Game()
+        : board(config.get()->window_width, config.get()->window_height), hand(&board), logic(&config)
     {
-        // Очистка файла журнала (log.txt) при старте новой игры.
-        ofstream fout(project_path + "log.txt", ios_base::trunc);
-        fout.close();
+        // Журнал (log.txt) начинается заново и пишется фоновым потоком.
+        logger().open(project_path + "log.txt", config.get()->log_level);
+        // Изменения settings.json подхватываются во время игры (уровни ботов, время, задержка - со следующего хода).
+        // Слежение запускается последним: перезагрузка пишет в уже открытый журнал.
+        config.watch();
+    }
+
+    /**
+     * @brief Запускает игру: главный поток создает окно и дальше только обрабатывает события SDL и рисует доску,
+     * а партии (play) идут в отдельном потоке, который никогда не ждет отрисовки.
+     * @return int: результат play().
+     */
+    int run()
+    {
+        if (board.start_draw())// Инициализация отрисовки (ошибка записана в log.txt).
+            return 0;
+        atomic<bool> finished(false);
+        int res = 0;
+        thread game_thread([this, &finished, &res]() {
+            res = play();
+            finished = true;
+            SDL_Event event{};
+            event.type = board.get_redraw_event();// Будим главный поток, чтобы он завершился.
+            SDL_PushEvent(&event);
+        });
+        SDL_Event windowEvent;
+        while (!finished)
+        {
+            // Ждем событие (таймаут - только страховка), затем разбираем все накопившиеся события
+            // и рисуем последний снимок доски: несколько изменений за кадр дают одну отрисовку.
+            if (SDL_WaitEventTimeout(&windowEvent, 100))
+            {
+                do
+                    hand.dispatch(windowEvent);
+                while (SDL_PollEvent(&windowEvent));
+            }
+            board.present();
+        }
+        game_thread.join();
+        return res;
     }
 
     // to start checkers
     /**
-     * @brief Главный цикл игры. Управляет сменой ходов, логикой конца игры и перезапуском.
+     * @brief Главный цикл игры (поток игры). Управляет сменой ходов, логикой конца игры и перезапуском.
      * @return int: 0 - выход/ничья, 1 - победа черных, 2 - победа белых.
      */
     int play()
     {
         auto start = chrono::steady_clock::now();// Запоминаем время начала игры.
+        game_stats = SearchStats();// Счетчики поиска за партию.
+        ++game_id;
+        hand.clear_input();// Клики с прошлой партии не относятся к новой.
 
         // Логика перезапуска/первого запуска.
         if (is_replay)
         {
-            logic = Logic(&board, &config);// Пересоздаем Logic для сброса состояния игры.
-            config.reload();// Перезагружаем настройки.
+            config.reload_logged();// Перезагружаем настройки (при ошибке в файле остаются прежние, ошибка - в log.txt).
+            logic = Logic(&config);// Пересоздаем Logic для сброса состояния игры (и очистки таблицы транспозиций).
             board.redraw();// Перерисовываем доску с новым состоянием.
         }
-        else
-        {
-            board.start_draw();// Первый запуск: инициализация отрисовки.
-        }
+        // При первом запуске доска уже нарисована в run().
         is_replay = false;// Сбрасываем флаг перезапуска.
 
         int turn_num = -1;
         bool is_quit = false;
-        const int Max_turns = config("Game", "MaxNumTurns");// Получаем лимит ходов из настроек.
+        const int Max_turns = config.get()->max_num_turns;// Получаем лимит ходов из настроек.
         while (++turn_num < Max_turns) // Главный игровой цикл.
         {
+            if (hand.quit_requested())// Окно закрыто (в партии ботов ввод не ждут, поэтому проверяем здесь).
+            {
+                is_quit = true;
+                break;
+            }
             beat_series = 0;// Сброс счетчика серии взятий в начале хода.
-            logic.find_turns(turn_num % 2);// Поиск всех возможных ходов для текущего игрока (0/1).
+            const auto settings = config.get();// Настройки на этот ход (файл может меняться во время игры).
+            const bool color = turn_num % 2;
+            logic.find_turns(Position(board.get_board()), color);// Поиск всех возможных ходов для текущего игрока (0/1).
 
             if (logic.turns.empty())// Условие конца игры: если возможных ходов нет.
                 break;
 
             // Установка глубины поиска для бота на основе настроек.
-            logic.Max_depth = config("Bot", string((turn_num % 2) ? "Black" : "White") + string("BotLevel"));
+            logic.Max_depth = settings->bot_level[color];
+            logic.update_settings(*settings);
 
             // Проверка, является ли текущий игрок человеком.
-            if (!config("Bot", string("Is") + string((turn_num % 2) ? "Black" : "White") + string("Bot")))
+            if (!settings->is_bot[color])
             {
-                auto resp = player_turn(turn_num % 2);// Ход человека: ожидание и обработка ввода.
+                // Пока человек думает, бот в фоне ищет ответ на его ожидаемый ход.
+                if (settings->ponder && settings->is_bot[!color])
+                {
+                    ponder.start(logic, Position(board.get_board()), color, settings->bot_level[!color]);
+                }
+                auto resp = player_turn(color);// Ход человека: ожидание и обработка ввода.
+                if (resp != Response::OK)// После отката, перезапуска или выхода ожидаемый ход уже не сыграть.
+                    ponder.cancel();
                 if (resp == Response::QUIT)// Обработка команды QUIT.
                 {
                     is_quit = true;
@@ -72,8 +126,7 @@ public:
                 else if (resp == Response::BACK)// Обработка команды BACK (откат).
                 {
                     // Откат хода бота (если предыдущий был ботом, и не было серии взятий).
-                    if (config("Bot", string("Is") + string((1 - turn_num % 2) ? "Black" : "White") + string("Bot")) &&
-                        !beat_series && board.history_mtx.size() > 2)
+                    if (settings->is_bot[!color] && !beat_series && board.history_size() > 1)
                     {
                         board.rollback();// Откатываем ход бота.
                         --turn_num;// Уменьшаем счетчик, чтобы следующим ходил бот.
@@ -88,15 +141,23 @@ public:
                 }
             }
             else
-                bot_turn(turn_num % 2);// Ход бота: вычисление и выполнение хода.
+                bot_turn(color, turn_num);// Ход бота: вычисление и выполнение хода.
         }
 
         // Логика завершения игры.
+        ponder.cancel();
         auto end = chrono::steady_clock::now();
-        // Запись времени игры в лог-файл.
-        ofstream fout(project_path + "log.txt", ios_base::app);
-        fout << "Game time: " << (int)chrono::duration<double, milli>(end - start).count() << " millisec\n";
-        fout.close();
+        // Запись итогов партии в журнал.
+        LogLine line(LogLevel::Info, "game_end");
+        line.field("game", game_id)
+            .field("turns", turn_num)
+            .field("result", is_replay ? "replay"
+                             : is_quit ? "quit"
+                             : turn_num == Max_turns ? "draw"
+                             : (turn_num % 2 ? "white" : "black"))
+            .field("time_ms", chrono::duration<double, milli>(end - start).count());
+        game_stats.log_fields(line);
+        logger().write(line);
 
         if (is_replay)// Рекурсивный вызов play() для перезапуска.
             return play();
@@ -113,6 +174,7 @@ public:
             res = 1;
         }
         board.show_final(res);// Отображение финального экрана.
+        hand.clear_input();// Клики, сделанные до появления финального экрана, не считаются командой.
         auto resp = hand.wait();// Ожидание команды REPLAY/QUIT после конца игры.
 
         if (resp == Response::REPLAY)// Обработка команды REPLAY.
@@ -127,22 +189,34 @@ private:
     /**
      * @brief Выполняет ход бота: ищет лучший ход, применяет задержку и совершает серию ходов.
      * @param color Цвет игрока (0 - белые, 1 - черные).
+     * @param ply Номер полухода в партии (для журнала).
      */
-    void bot_turn(const bool color)
+    void bot_turn(const bool color, const int ply)
     {
         auto start = chrono::steady_clock::now();// Запоминаем время начала хода.
 
-        auto delay_ms = config("Bot", "BotDelayMS");// Получаем минимальную задержку из настроек.
+        const auto settings = config.get();
+        const int delay_ms = settings->bot_delay_ms;// Получаем минимальную задержку из настроек.
         // Запускаем отдельный поток для задержки, чтобы обеспечить минимальное время хода,
         // даже если поиск хода завершился быстро.
         thread th(SDL_Delay, delay_ms);
-        auto turns = logic.find_best_turns(color);// Запускаем поиск лучшего хода (может быть серией).
+        // Движок получает копию позиции и не зависит от доски и отрисовки.
+        const Position pos(board.get_board());
+        full_turn best;
+        SearchStats stats;
+        // Если человек сыграл ожидаемый ход, ход бота уже найден (или ищется) обдумыванием.
+        const bool ponder_hit = ponder.take(pos, color, settings->bot_time_ms, best, stats);
+        if (!ponder_hit)
+        {
+            best = logic.find_best_turn(pos, color);// Запускаем поиск лучшего хода (серия взятий - один ход).
+            stats = logic.last_stats();
+        }
         th.join();// Ожидаем завершения задержки (минимум delay_ms).
 
         bool is_first = true;
         // making moves
-        // Выполнение серии ходов (если есть взятие, то это несколько шагов).
-        for (auto turn : turns)
+        // Выполнение хода по шагам (серия взятий показывается по одному взятию).
+        for (auto turn : logic.turn_steps(pos, best))
         {
             if (!is_first)// Добавляем задержку между отдельными шагами серии взятий.
             {
@@ -154,10 +228,21 @@ private:
         }
 
         auto end = chrono::steady_clock::now();
-        // Запись времени хода бота в лог-файл.
-        ofstream fout(project_path + "log.txt", ios_base::app);
-        fout << "Bot turn time: " << (int)chrono::duration<double, milli>(end - start).count() << " millisec\n";
-        fout.close();
+        // Запись хода бота в журнал (строка формируется, только если уровень журнала ее пропускает).
+        if (logger().enabled(LogLevel::Info))
+        {
+            LogLine line(LogLevel::Info, "bot_turn");
+            line.field("game", game_id)
+                .field("ply", ply)
+                .field("side", color ? "black" : "white")
+                .field("source", stats.source)
+                .field("depth", stats.depth())// Завершенная глубина, а не уровень бота: время могло кончиться раньше.
+                .field("time_ms", chrono::duration<double, milli>(end - start).count())
+                .field("ponder_hit", ponder_hit);
+            stats.log_fields(line);
+            logger().write(line);
+        }
+        game_stats.add(stats);
     }
 
     Response player_turn(const bool color)
@@ -170,6 +255,7 @@ private:
             cells.emplace_back(turn.x, turn.y);
         }
         board.highlight_cells(cells);// Подсвечиваем доступные для хода шашки.
+        hand.clear_input();// Клики во время хода бота и анимации не считаются ходом человека.
         move_pos pos = { -1, -1, -1, -1 };// Переменная для хранения сделанного хода.
         POS_T x = -1, y = -1;// Координаты выбранной шашки (начальная позиция).
         // trying to make first move
@@ -244,7 +330,7 @@ private:
         while (true)
         {
             // Ищем возможные ходы (взятия) только для шашки, которая только что била.
-            logic.find_turns(pos.x2, pos.y2);
+            logic.find_turns(Position(board.get_board()), pos.x2, pos.y2);
             if (!logic.have_beats)// Если дальнейшее взятие невозможно, серия завершена.
                 break;
 
@@ -294,6 +380,9 @@ private:
     Board board;
     Hand hand;
     Logic logic;
+    Ponder ponder;
+    SearchStats game_stats;
+    int game_id = 0;// Номер партии с запуска программы (для журнала).
     int beat_series;
     bool is_replay = false;
 };
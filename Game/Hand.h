@@ -1,4 +1,9 @@
 #pragma once
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
 #include <tuple>
 
 #include "../Models/Move.h"
@@ -6,6 +11,8 @@
 #include "Board.h"
 
 // Класс Hand отвечает за обработку ввода пользователя (кликов мыши) и системных событий SDL.
+// События SDL принимает главный поток (dispatch), а ждет ввода поток игры (get_cell, wait):
+// клики и выход передаются между ними через очередь.
 class Hand
 {
 public:
@@ -14,110 +21,150 @@ public:
     {
     }
     /**
-     * @brief Ожидает и обрабатывает одно событие, которое может быть кликом по клетке или командой.
+     * @brief Ожидает и обрабатывает одно событие, которое может быть кликом по клетке или командой (поток игры).
      * @return tuple<Response, POS_T, POS_T>: тип ответа (CELL, QUIT и т.д.) и координаты клетки (xc, yc).
      */
-    tuple<Response, POS_T, POS_T> get_cell() const
+    tuple<Response, POS_T, POS_T> get_cell()
     {
-        SDL_Event windowEvent;
         Response resp = Response::OK;
-        int x = -1, y = -1;// Координаты клика в пикселях.
         int xc = -1, yc = -1;// Координаты клетки (0-7), или -1 для системных зон.
-        while (true) // Цикл ожидания события.
+        while (resp == Response::OK) // Цикл ожидания события.
         {
-            if (SDL_PollEvent(&windowEvent)) // Проверяем наличие событий.
+            const Input input = next_input(); // Поток спит, пока нет ввода.
+            xc = input.xc;
+            yc = input.yc;
+            if (input.quit)
             {
-                switch (windowEvent.type)
-                {
-                case SDL_QUIT:
-                    resp = Response::QUIT;// Команда выхода из окна.
-                    break;
-                case SDL_MOUSEBUTTONDOWN:
-                    x = windowEvent.motion.x;
-                    y = windowEvent.motion.y;
-                    // Преобразование пиксельных координат в координаты клетки (0-7).
-                    xc = int(y / (board->H / 10) - 1);// Координата строки (0-7).
-                    yc = int(x / (board->W / 10) - 1);// Координата столбца (0-7).
-
-                    // Условие для кнопки "Отменить ход" (BACK): зона (-1, -1) и наличие истории.
-                    if (xc == -1 && yc == -1 && board->history_mtx.size() > 1)
-                    {
-                        resp = Response::BACK;
-                    }
-                    // Условие для кнопки "Перезапуск" (REPLAY): зона (-1, 8).
-                    else if (xc == -1 && yc == 8)
-                    {
-                        resp = Response::REPLAY;
-                    }
-                    // Условие для клика по игровой клетке (0-7).
-                    else if (xc >= 0 && xc < 8 && yc >= 0 && yc < 8)
-                    {
-                        resp = Response::CELL;
-                    }
-                    else
-                    {
-                        // Клик вне активных зон игнорируется.
-                        xc = -1;
-                        yc = -1;
-                    }
-                    break;
-                case SDL_WINDOWEVENT:
-                    // Обработка изменения размера окна (перерисовка).
-                    if (windowEvent.window.event == SDL_WINDOWEVENT_SIZE_CHANGED)
-                    {
-                        board->reset_window_size();
-                        break;
-                    }
-                }
-                // Выходим, если получена команда.
-                if (resp != Response::OK)
-                    break;
+                resp = Response::QUIT;// Команда выхода из окна.
+            }
+            // Условие для кнопки "Отменить ход" (BACK): зона (-1, -1) и наличие истории.
+            else if (xc == -1 && yc == -1 && board->history_size() > 0)
+            {
+                resp = Response::BACK;
+            }
+            // Условие для кнопки "Перезапуск" (REPLAY): зона (-1, 8).
+            else if (xc == -1 && yc == 8)
+            {
+                resp = Response::REPLAY;
+            }
+            // Условие для клика по игровой клетке (0-7).
+            else if (xc >= 0 && xc < 8 && yc >= 0 && yc < 8)
+            {
+                resp = Response::CELL;
             }
         }
+        if (resp != Response::CELL)
+        {
+            xc = -1;
+            yc = -1;
+        }
         // Возвращаем тип ответа и координаты.
         return { resp, xc, yc };
     }
 
     /**
-     * @brief Ожидает команду QUIT или REPLAY (обычно после конца игры).
+     * @brief Ожидает команду QUIT или REPLAY (обычно после конца игры; поток игры).
      * @return Response: QUIT или REPLAY.
      */
-    Response wait() const
+    Response wait()
     {
-        SDL_Event windowEvent;
-        Response resp = Response::OK;
         while (true) // Цикл ожидания события.
         {
-            if (SDL_PollEvent(&windowEvent))
+            const Input input = next_input();
+            if (input.quit)
+                return Response::QUIT;
+            // Проверка на клик по кнопке "Перезапуск" (REPLAY) в зоне (-1, 8).
+            if (input.xc == -1 && input.yc == 8)
+                return Response::REPLAY;
+        }
+    }
+
+    /**
+     * @brief Обрабатывает событие SDL (главный поток): события окна - сразу, клики и выход - в очередь потока игры.
+     * @param windowEvent Событие из очереди SDL.
+     */
+    void dispatch(const SDL_Event& windowEvent)
+    {
+        switch (windowEvent.type)
+        {
+        case SDL_QUIT:
+            quit = true;
+            push({ true, -1, -1 });
+            break;
+        case SDL_MOUSEBUTTONDOWN: {
+            // Преобразование пиксельных координат в координаты клетки (0-7; -1 и 8 - системные зоны)
+            // по размерам окна на момент клика.
+            const int xc = int(windowEvent.button.y / (board->H / 10) - 1);// Координата строки.
+            const int yc = int(windowEvent.button.x / (board->W / 10) - 1);// Координата столбца.
+            push({ false, xc, yc });
+        }
+        break;
+        case SDL_RENDER_TARGETS_RESET:
+            board->reset_window_size(); // Содержимое кадра потеряно, он рисуется заново.
+            break;
+        case SDL_WINDOWEVENT:
+            switch (windowEvent.window.event)
             {
-                switch (windowEvent.type)
-                {
-                case SDL_QUIT:
-                    resp = Response::QUIT;
-                    break;
-                case SDL_WINDOWEVENT_SIZE_CHANGED:
-                    board->reset_window_size();
-                    break;
-                case SDL_MOUSEBUTTONDOWN: {
-                    int x = windowEvent.motion.x;
-                    int y = windowEvent.motion.y;
-                    // Преобразование клика в координаты (проверка системных зон).
-                    int xc = int(y / (board->H / 10) - 1);
-                    int yc = int(x / (board->W / 10) - 1);
-                    // Проверка на клик по кнопке "Перезапуск" (REPLAY) в зоне (-1, 8).
-                    if (xc == -1 && yc == 8)
-                        resp = Response::REPLAY;
-                }
-                                        break;
-                }
-                // Выходим, если получена команда.
-                if (resp != Response::OK)
-                    break;
+            case SDL_WINDOWEVENT_SIZE_CHANGED:
+            case SDL_WINDOWEVENT_EXPOSED: // Окно было перекрыто или свернуто.
+                board->reset_window_size(); // Новые размеры и перерисовка.
+                break;
             }
+            break;
         }
-        return resp; // Возвращаем команду.
+    }
+
+    /**
+     * @brief Отбрасывает клики, накопившиеся, пока ввод не ждали (ход бота, анимация, финальный экран),
+     * чтобы они не стали ходом или командой (поток игры). Выход из окна не отбрасывается.
+     */
+    void clear_input()
+    {
+        lock_guard<mutex> lock(input_mutex);
+        inputs.erase(remove_if(inputs.begin(), inputs.end(), [](const Input& input) { return !input.quit; }),
+                     inputs.end());
+    }
+
+    /**
+     * @brief Было ли закрыто окно (для партий бота с ботом, где ввод не ждут).
+     */
+    bool quit_requested() const
+    {
+        return quit;
     }
 
 private:
+    // Ввод для потока игры: выход или клик по клетке (координаты клетки, -1 и 8 - системные зоны).
+    struct Input
+    {
+        bool quit;
+        int xc, yc;
+    };
+
+    void push(const Input& input)
+    {
+        {
+            lock_guard<mutex> lock(input_mutex);
+            inputs.push_back(input);
+        }
+        input_ready.notify_one();
+    }
+
+    /**
+     * @brief Ожидает следующий ввод, не занимая процессор.
+     */
+    Input next_input()
+    {
+        unique_lock<mutex> lock(input_mutex);
+        input_ready.wait(lock, [this]() { return !inputs.empty(); });
+        const Input input = inputs.front();
+        inputs.pop_front();
+        return input;
+    }
+
     Board* board;// Указатель на Board для взаимодействия с доской и получения ее размеров.
+    mutex input_mutex;
+    condition_variable input_ready;
+    deque<Input> inputs;
+    atomic<bool> quit{false};
 };
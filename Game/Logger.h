@@ -0,0 +1,306 @@
+#pragma once
+#include <stdint.h>
+#include <stdio.h>
+#include <atomic>
+#include <cmath>
+#include <chrono>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <type_traits>
+
+// Уровень записи журнала; записи ниже уровня журнала не формируются вовсе (Logger::enabled).
+enum class LogLevel
+{
+    Debug,   // подробности поиска (каждая итерация углубления)
+    Info,    // ходы бота, партии, перезагрузка настроек
+    Warning, // ошибки, после которых игра продолжается (неверный settings.json)
+    Error,   // ошибки SDL и загрузки текстур
+    Off      // журнал не ведется (инструменты без окна)
+};
+
+/**
+ * @brief Одна запись журнала - строка JSON: время (ts, мс от 1970), уровень, событие и поля записи.
+ * Пример: {"ts":1760000000000,"level":"info","event":"bot_turn","game":1,"ply":3,"side":"black",...}
+ */
+class LogLine
+{
+public:
+    LogLine(const LogLevel level, const char* event) : level(level)
+    {
+        static const char* const names[] = { "debug", "info", "warning", "error", "off" };
+        const auto ts = std::chrono::duration_cast<std::chrono::milliseconds>(
+                            std::chrono::system_clock::now().time_since_epoch())
+                            .count();
+        text = "{\"ts\":" + std::to_string(ts) + ",\"level\":\"" + names[int(level)] + "\"";
+        field("event", event);
+    }
+
+    template <class T, class = typename std::enable_if<std::is_integral<T>::value>::type>
+    LogLine& field(const char* key, const T value)
+    {
+        add_key(key);
+        text += std::to_string(value);
+        return *this;
+    }
+
+    LogLine& field(const char* key, const bool value)
+    {
+        add_key(key);
+        text += (value ? "true" : "false");
+        return *this;
+    }
+
+    LogLine& field(const char* key, const double value)
+    {
+        add_key(key);
+        if (!std::isfinite(value)) // nan и inf не являются числами JSON
+        {
+            text += "null";
+            return *this;
+        }
+        char buf[32];
+        snprintf(buf, sizeof(buf), "%.1f", value);
+        text += buf;
+        return *this;
+    }
+
+    LogLine& field(const char* key, const std::string& value)
+    {
+        add_key(key);
+        text += '"';
+        for (const char c : value)
+        {
+            if (c == '"' || c == '\\')
+            {
+                text += '\\';
+                text += c;
+            }
+            else if (c == '\n')
+                text += "\\n";
+            else if (static_cast<unsigned char>(c) < 0x20)
+            {
+                char buf[8];
+                snprintf(buf, sizeof(buf), "\\u%04x", c);
+                text += buf;
+            }
+            else
+                text += c;
+        }
+        text += '"';
+        return *this;
+    }
+
+    LogLine& field(const char* key, const char* value)
+    {
+        return field(key, std::string(value ? value : ""));
+    }
+
+    /**
+     * @brief Поле с готовым значением JSON (массив или объект), вставляется как есть.
+     */
+    LogLine& raw_field(const char* key, const std::string& json_value)
+    {
+        add_key(key);
+        text += json_value;
+        return *this;
+    }
+
+    const LogLevel level;
+
+private:
+    friend class Logger;
+
+    void add_key(const char* key)
+    {
+        text += ",\"";
+        text += key;
+        text += "\":";
+    }
+
+    std::string text; // без закрывающей скобки: ее добавляет Logger::write
+};
+
+/**
+ * @brief Журнал log.txt в формате JSON lines. Записи кладутся в кольцевую очередь без блокировок
+ * (любой поток, ход игры не ждет диска), а фоновый поток забирает их пачками и пишет одним вызовом.
+ * Если очередь переполнена, запись отбрасывается и учитывается в событии "log_dropped".
+ */
+class Logger
+{
+public:
+    // Размер очереди (степень двойки).
+    static constexpr size_t QUEUE_SIZE = 4096;
+
+    Logger() : slots(new Slot[QUEUE_SIZE])
+    {
+        for (size_t i = 0; i < QUEUE_SIZE; ++i)
+            slots[i].seq.store(i, std::memory_order_relaxed);
+    }
+
+    Logger(const Logger&) = delete;
+    Logger& operator=(const Logger&) = delete;
+
+    ~Logger()
+    {
+        close();
+    }
+
+    /**
+     * @brief Открывает файл журнала заново (старое содержимое стирается) и запускает фоновую запись.
+     * @param path Путь к файлу.
+     * @param level Наименьший записываемый уровень.
+     */
+    void open(const std::string& path, const LogLevel level)
+    {
+        close();
+        fout.open(path, std::ios_base::trunc);
+        stop = false;
+        writer = std::thread(&Logger::write_loop, this);
+        set_level(level);
+        is_open.store(true);
+    }
+
+    /**
+     * @brief Меняет наименьший записываемый уровень (например, после перезагрузки настроек).
+     */
+    void set_level(const LogLevel level)
+    {
+        min_level.store(int(level), std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Будет ли записана запись этого уровня: проверяется до формирования дорогих записей.
+     */
+    bool enabled(const LogLevel level) const
+    {
+        return is_open.load() && int(level) >= min_level.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Ставит запись в очередь (без блокировок и без обращения к диску).
+     */
+    void write(const LogLine& line)
+    {
+        if (!enabled(line.level))
+            return;
+        // Запись считается начатой до повторной проверки: close() либо увидит ее и дождется,
+        // либо она увидит закрытый журнал. Иначе запись могла бы попасть в очередь после
+        // последнего разбора и оказаться в следующем файле.
+        in_flight.fetch_add(1);
+        if (enabled(line.level) && !push(line.text + "}\n"))
+            dropped.fetch_add(1, std::memory_order_relaxed);
+        in_flight.fetch_sub(1);
+    }
+
+    /**
+     * @brief Дописывает все записи из очереди и закрывает файл.
+     */
+    void close()
+    {
+        is_open.store(false);
+        if (!writer.joinable())
+            return;
+        while (in_flight.load()) // Ждем записи, начатые до закрытия.
+            std::this_thread::yield();
+        stop = true;
+        writer.join();
+        fout.close();
+    }
+
+private:
+    struct Slot
+    {
+        std::atomic<size_t> seq; // номер записи, которую ждет ячейка (схема ограниченной очереди Вьюкова)
+        std::string text;
+    };
+
+    /**
+     * @brief Добавление в очередь из любого потока.
+     * @return bool: false, если очередь заполнена.
+     */
+    bool push(std::string&& text)
+    {
+        size_t pos = head.load(std::memory_order_relaxed);
+        while (true)
+        {
+            Slot& slot = slots[pos & (QUEUE_SIZE - 1)];
+            const size_t seq = slot.seq.load(std::memory_order_acquire);
+            const intptr_t diff = intptr_t(seq) - intptr_t(pos);
+            if (diff == 0)
+            {
+                if (head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                {
+                    slot.text = std::move(text);
+                    slot.seq.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (diff < 0)
+                return false; // Ячейка еще не прочитана фоновым потоком: очередь полна.
+            else
+                pos = head.load(std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * @brief Извлечение из очереди (только фоновый поток).
+     */
+    bool pop(std::string& text)
+    {
+        Slot& slot = slots[tail & (QUEUE_SIZE - 1)];
+        if (slot.seq.load(std::memory_order_acquire) != tail + 1)
+            return false;
+        text.swap(slot.text);
+        slot.text.clear();
+        slot.seq.store(tail + QUEUE_SIZE, std::memory_order_release);
+        ++tail;
+        return true;
+    }
+
+    void write_loop()
+    {
+        std::string batch, text;
+        while (true)
+        {
+            const bool last = stop; // После остановки очередь дописывается до конца.
+            while (pop(text))
+                batch += text;
+            const uint64_t lost = dropped.exchange(0, std::memory_order_relaxed);
+            if (lost)
+                batch += LogLine(LogLevel::Warning, "log_dropped").field("count", lost).text + "}\n";
+            const bool idle = batch.empty();
+            if (!idle)
+            {
+                fout.write(batch.data(), std::streamsize(batch.size()));
+                fout.flush();
+                batch.clear();
+            }
+            if (last)
+                break;
+            if (idle) // Пока записи идут, очередь разбирается без пауз.
+                std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        }
+    }
+
+    std::unique_ptr<Slot[]> slots;
+    std::atomic<size_t> head{ 0 }; // следующая позиция записи
+    size_t tail = 0;               // следующая позиция чтения (только фоновый поток)
+    std::atomic<bool> is_open{ false }; // открыт ли журнал (writer меняют только open/close, другие потоки его не читают)
+    std::atomic<int> in_flight{ 0 };    // записи, которые сейчас кладутся в очередь (см. write и close)
+    std::atomic<int> min_level{ int(LogLevel::Info) };
+    std::atomic<uint64_t> dropped{ 0 };
+    std::atomic<bool> stop{ false };
+    std::thread writer;
+    std::ofstream fout;
+};
+
+/**
+ * @brief Общий журнал процесса; до Logger::open записи не ведутся.
+ */
+inline Logger& logger()
+{
+    static Logger instance;
+    return instance;
+}
@@ -1,519 +1,1043 @@
 #pragma once
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
 #include <random>
+#include <string>
+#include <thread>
 #include <vector>
-#include <algorithm> //   std::max/min
+#include <algorithm> // Добавлен для std::max/min
 
 #include "../Models/Move.h"
-#include "Board.h"
+#include "../Models/Position.h"
+#include "../Models/Project_path.h"
+#include "Book.h"
 #include "Config.h"
+#include "Logger.h"
+#include "MoveGen.h"
+#include "SearchStats.h"
+#include "Tablebase.h"
+#include "TransTable.h"
 
-// ,  ,    / .
-const int INF = 1e9;
+using namespace std;
+
+// Шкала оценок: целые числа с точки зрения игрока, который ходит (negamax), 100 - одна шашка.
+// Выигрыш через n полуходов от корня поиска - SCORE_WIN - n, проигрыш - -(SCORE_WIN - n),
+// поэтому из двух выигрышей больше оценка у более быстрого.
+const int SCORE_WIN = 30000;
+// Граница окна поиска: больше модуля любой оценки.
+const int SCORE_INF = 32000;
+// Оценки не меньше по модулю - выигрыш или проигрыш с известным расстоянием (с запасом на глубину и базу эндшпилей).
+const int SCORE_WIN_MIN = SCORE_WIN - 1000;
+// Ценность шашки.
+const int MAN_VALUE = 100;
+// Полуширина окна вокруг оценки прошлой итерации углубления (O2).
+const int ASPIRATION_WINDOW = 50;
+// С какого по счету хода узла (от 0) тихие ходы ищутся с сокращенной на 1 глубиной (O2).
+const int LMR_FIRST_TURN = 3;
+// Наименьшая оставшаяся глубина узла, в котором ходы сокращаются (O2).
+const int LMR_MIN_REMAINING = 3;
+
+/**
+ * @brief Оценка - найденный выигрыш игрока, который ходит.
+ */
+inline bool is_win_score(const int score)
+{
+    return score >= SCORE_WIN_MIN;
+}
+
+/**
+ * @brief Оценка - найденный проигрыш игрока, который ходит.
+ */
+inline bool is_loss_score(const int score)
+{
+    return score <= -SCORE_WIN_MIN;
+}
+// Наибольшая глубина, для которой хранятся ходы-убийцы.
+const int MAX_PLY = 64;
 
 class Logic
 {
 public:
     /**
-     * @brief        /.
+     * @brief Список всех найденных возможных ходов для текущего игрока/шашки.
      */
     vector<move_pos> turns;
     /**
-     * @brief , ,       .
+     * @brief Флаг, указывающий, есть ли среди найденных ходов обязательные взятия.
      */
     bool have_beats;
     /**
-     * @brief     (Minimax/Alpha-Beta)  .
-     *   Game::play()   .
+     * @brief Максимальная глубина рекурсивного поиска (Minimax/Alpha-Beta) для бота.
+     * Устанавливается в Game::play() на основе настроек.
      */
     int Max_depth;
 
     /**
-         * @brief   Logic.
-         * @param board    Board (  ).
-         * @param config    Config ( ).
+         * @brief Конструктор класса Logic.
+         * Logic не зависит от SDL и от Board: позиция передается в каждый вызов,
+         * поэтому движок работает и без окна (Game/Match.h, Tools/).
+         * @param config Указатель на объект Config (настройки игры).
          */
-    Logic(Board* board, Config* config) : board(board), config(config)
+    explicit Logic(Config* config) : config(config)
     {
-        //    .
-        //  "NoRandom"  ,     seed.
-        rand_eng = std::default_random_engine(
-            !((*config)("Bot", "NoRandom")) ? unsigned(time(0)) : 0);
-        //     (, "NumberAndPotential").
-        scoring_mode = (*config)("Bot", "BotScoringType");
-        //    (, "O0" -  , "AB" - Alpha-Beta).
-        optimization = (*config)("Bot", "Optimization");
+        const auto settings = config->get();
+        // Инициализация генератора случайных чисел.
+        // Если "NoRandom" не установлен, используется текущее время для seed.
+        no_random = settings->no_random;
+        rand_eng = std::default_random_engine(!no_random ? unsigned(time(0)) : 0);
+        // Режимы оценки и оптимизации задаются один раз: поиск специализирован под них шаблонами.
+        scoring_mode = settings->scoring;
+        optimization = settings->optimization;
+        // Таблица транспозиций создается пустой при каждом создании Logic (в том числе при перезапуске игры).
+        const size_t hash_size_mb = size_t(settings->hash_size_mb);
+        tt = make_shared<TransTable>(hash_size_mb);
+        // Число потоков поиска (0 - по числу ядер).
+        threads = unsigned(settings->bot_threads);
+        if (threads == 0)
+            threads = max(1u, thread::hardware_concurrency());
+        // Для детерминированной игры каждому потоку нужна своя таблица: общая таблица
+        // делает результат зависимым от того, какой поток раньше записал позицию.
+        // Объем делится между потоками, но не меньше 1 МБ на поток (иначе помощники искали бы без таблицы);
+        // HashSizeMB = 0 по-прежнему отключает таблицу во всех потоках.
+        if (threads > 1 && no_random)
+        {
+            const size_t helper_mb = hash_size_mb ? max<size_t>(1, hash_size_mb / threads) : 0;
+            for (unsigned t = 0; t < threads; ++t)
+                helper_tt.push_back(make_shared<TransTable>(helper_mb));
+        }
+        update_settings(*settings);
+        // База эндшпилей (строится Tools/tb_gen); если файла нет, бот просто считает эти позиции поиском.
+        const string& tablebase_file = settings->tablebase_file;
+        tablebase = make_shared<Tablebase>(tablebase_file.empty() ? string() : project_path + tablebase_file);
+        // Книга дебютов (строится Tools/book_gen); если файла нет, дебют считается поиском.
+        const string& book_file = settings->book_file;
+        book = make_shared<Book>(book_file.empty() ? string() : project_path + book_file);
+        age_ordering();
     }
 
-    // ---   find_turns() ---
+    /**
+     * @brief Применяет настройки, которые можно менять между ходами без пересоздания движка
+     * (остальные - таблица, потоки, режимы поиска, книга и база - применяются при создании Logic).
+     * @param settings Снимок настроек.
+     */
+    void update_settings(const Settings& settings)
+    {
+        // Бюджет времени на ход для итеративного углубления.
+        time_limit_ms = settings.bot_time_ms;
+        // Лимит узлов форсированного продолжения взятий на один лист (0 - без продолжения).
+        quiescence_limit = unsigned(settings.quiescence_nodes);
+    }
 
     /**
-     * @brief            .
-     * (   Game::play() -   Board::mtx)
-     * @param color   (0 - , 1 - ).
+     * @brief Задает seed генератора случайного порядка ходов (например, чтобы партии самоигры различались).
      */
-    void find_turns(const bool color)
+    void seed(const unsigned value)
     {
-        find_turns(color, board->get_board());
+        rand_eng.seed(value);
     }
 
+    // --- Перегруженные функции find_turns() ---
+
     /**
-     * @brief     (   )      .
-     * (   Game::play() -   Board::mtx)
-     * @param x  X () .
-     * @param y  Y () .
+     * @brief Ищет все возможные ходы для игрока заданного цвета.
+     * (Публичный интерфейс для Game::play() - позиция строится по Board::mtx)
+     * @param pos Позиция.
+     * @param color Цвет игрока (0 - белые, 1 - черные).
      */
-    void find_turns(const POS_T x, const POS_T y)
+    void find_turns(const Position& pos, const bool color)
     {
-        find_turns(x, y, board->get_board());
+        MoveList list;
+        have_beats = gen_turns(pos, color, list);
+        set_turns(list);
     }
 
-    // ---     ---
+    /**
+     * @brief Ищет все возможные ходы (включая продолжение серии взятий) для конкретной шашки.
+     * @param pos Позиция.
+     * @param x Координата X (строка) шашки.
+     * @param y Координата Y (столбец) шашки.
+     */
+    void find_turns(const Position& pos, const POS_T x, const POS_T y)
+    {
+        MoveList list;
+        have_beats = gen_turns_from(pos, sq_index(x, y), list);
+        set_turns(list);
+    }
 
 private:
     /**
-     * @brief            .
-     *   .      ,   .
-     * @param color   (0 - , 1 - ).
-     * @param mtx  ,    .
+     * @brief Переводит найденные ходы в координаты доски для Game (поле turns).
      */
-    void find_turns(const bool color, const vector<vector<POS_T>>& mtx)
+    void set_turns(const MoveList& list)
     {
-        vector<move_pos> res_turns;
-        bool have_beats_before = false;
-        //    
-        for (POS_T i = 0; i < 8; ++i)
-        {
-            for (POS_T j = 0; j < 8; ++j)
-            {
-                //       
-                if (mtx[i][j] && mtx[i][j] % 2 != color)
-                {
-                    find_turns(i, j, mtx); //     
+        turns.clear();
+        for (const move_code turn : list)
+            turns.push_back(to_move_pos(turn));
+    }
 
-                    //    ,    :
-                    //     (..  )
-                    if (have_beats && !have_beats_before)
-                    {
-                        have_beats_before = true;
-                        res_turns.clear();
-                    }
+    // --- Функции для логики бота ---
 
-                    //   :
-                    // -      (have_beats_before)       (have_beats)
-                    // -       (   )
-                    if ((have_beats_before && have_beats) || !have_beats_before)
-                    {
-                        res_turns.insert(res_turns.end(), turns.begin(), turns.end());
-                    }
-                }
-            }
-        }
-        turns = res_turns;
-        //  :    ( ).
-        shuffle(turns.begin(), turns.end(), rand_eng);
-        have_beats = have_beats_before;
+    /**
+     * @brief Статическая оценка позиции: разность материала и сумм таблицы "фигура-клетка".
+     * Слагаемые ведет сама позиция (Position::count, Position::psq), поэтому оценка - несколько сложений.
+     * @tparam S Режим оценки: NumberOnly - только материал (дамка - 4 шашки),
+     * NumberAndPotential - дамка - 5 шашек и продвижение шашек по таблице.
+     * @param pos Позиция для оценки.
+     * @param color Цвет игрока, который ходит.
+     * @return int Оценка с точки зрения игрока color (больше - лучше для него).
+     */
+    template <Scoring S> int calc_score(const Position& pos, const bool color) const
+    {
+        constexpr int king_value = (S == Scoring::NumberAndPotential ? 5 : 4) * MAN_VALUE;
+        int score = (pos.count[1] - pos.count[2]) * MAN_VALUE + (pos.count[3] - pos.count[4]) * king_value;
+        if constexpr (S == Scoring::NumberAndPotential)
+            score += pos.psq[0] - pos.psq[1];
+        return color ? -score : score;
     }
 
     /**
-     * @brief           .
-     *   ,   ,    .
-     * @param x  X () .
-     * @param y  Y () .
-     * @param mtx  ,    .
+     * @brief Оценка листа поиска: игрок без фигур проиграл, иначе статическая оценка.
+     * @param depth Глубина листа (для расстояния до проигрыша).
      */
-    void find_turns(const POS_T x, const POS_T y, const vector<vector<POS_T>>& mtx)
+    template <Scoring S> int leaf_score(const Position& pos, const bool color, const size_t depth)
     {
-        turns.clear();
-        have_beats = false;
-        POS_T type = mtx[x][y];
-        // check beats
-        switch (type)
-        {
-        case 1:
-        case 2:
-            // check pieces ()
-            for (POS_T i = x - 2; i <= x + 2; i += 4)
-            {
-                for (POS_T j = y - 2; j <= y + 2; j += 4)
-                {
-                    if (i < 0 || i > 7 || j < 0 || j > 7)
-                        continue;
-                    POS_T xb = (x + i) / 2, yb = (y + j) / 2;
-                    //    :
-                    // 1.   (i, j)  (mtx[i][j] == 0)
-                    // 2.   (xb, yb)  
-                    // 3.    
-                    if (mtx[i][j] || !mtx[xb][yb] || mtx[xb][yb] % 2 == type % 2)
-                        continue;
-                    turns.emplace_back(x, y, i, j, xb, yb);
-                }
-            }
-            break;
-        default:
-            // check queens () -    
-            for (POS_T i = -1; i <= 1; i += 2)
-            {
-                for (POS_T j = -1; j <= 1; j += 2)
-                {
-                    POS_T xb = -1, yb = -1; //    
-                    //   
-                    for (POS_T i2 = x + i, j2 = y + j; i2 != 8 && j2 != 8 && i2 != -1 && j2 != -1; i2 += i, j2 += j)
-                    {
-                        if (mtx[i2][j2]) //  
-                        {
-                            //          
-                            if (mtx[i2][j2] % 2 == type % 2 || (mtx[i2][j2] % 2 != type % 2 && xb != -1))
-                            {
-                                break; //  
-                            }
-                            xb = i2; //   
-                            yb = j2;
-                        }
-                        //     (xb != -1)       (xb != i2),
-                        // ,   (i2, j2)    ,     .
-                        if (xb != -1 && xb != i2)
-                        {
-                            turns.emplace_back(x, y, i2, j2, xb, yb);
-                        }
-                    }
-                }
-            }
-            break;
-        }
+        ++stats.leaves;
+        if (!pos.pieces(color))
+            return -(SCORE_WIN - int(depth));
+        return calc_score<S>(pos, color);
+    }
+
+public:
+    /**
+     * @brief Запускает поиск лучшего хода для бота.
+     * @param root Позиция, в которой ходит бот.
+     * @param color Цвет бота.
+     * @return full_turn Лучший полный ход (серия взятий целиком); code == move_code(0, 0), если ходов нет.
+     */
+    full_turn find_best_turn(const Position& root, const bool color)
+    {
+        const int target_depth = Max_depth;
+        const auto start = chrono::steady_clock::now();
+        stats = SearchStats();
+        stats.turns = 1;
+        deadline = start + chrono::milliseconds(time_limit_ms);
+        time_check = false; // Первая итерация всегда доводится до конца, чтобы ход был всегда.
+        stopped = false;
+        root_best = move_code(0, 0);
+        root_score = 0;
+        age_ordering();
 
-        // check other turns (  )
-        if (!turns.empty())
+        // Итеративное углубление: поиск на глубину 1, 2, ... до уровня бота или до конца времени.
+        // Ход берется из последней полностью завершенной итерации.
+        full_turn res{move_code(0, 0), 0, false};
+        // Выигранный или проигранный эндшпиль из базы играется по расстоянию до конца партии.
+        if (find_tablebase_turn(root, color, res))
         {
-            have_beats = true; //  ,    .
-            return;
+            stats.source = "tablebase";
+            return res;
         }
-
-        switch (type)
+        // Позиция из книги дебютов: ход без поиска.
+        if (find_book_turn(root, color, res))
         {
-        case 1:
-        case 2:
-            // check pieces ()
+            stats.source = "book";
+            return res;
+        }
+        for (Max_depth = 1;; ++Max_depth)
         {
-            //   :  (1)   (+1),  (2)   (-1).
-            POS_T i = ((type % 2) ? x - 1 : x + 1);
-            for (POS_T j = y - 1; j <= y + 1; j += 2)
+            const uint64_t nodes_before = stats.nodes;
+            // Вся рекурсия изменяет одну позицию через make/unmake.
+            Position pos = root;
+            full_turn iter_res{move_code(0, 0), 0, false};
+            const int score = search_iteration(pos, color, iter_res);
+            if (stopped) // Итерация прервана по времени - ее результат неполный.
+                break;
+            stats.depth_nodes.push_back(stats.nodes - nodes_before);
+            res = iter_res;
+            root_best = res.code; // Лучший ход итерации будет первым на следующей.
+            root_score = score;
+            if (logger().enabled(LogLevel::Debug))
             {
-                //         .
-                if (i < 0 || i > 7 || j < 0 || j > 7 || mtx[i][j])
-                    continue;
-                turns.emplace_back(x, y, i, j);
+                logger().write(LogLine(LogLevel::Debug, "search_iteration")
+                                   .field("side", color ? "black" : "white")
+                                   .field("depth", Max_depth)
+                                   .field("score", score)
+                                   .field("nodes", stats.depth_nodes.back())
+                                   .field("time_ms", chrono::duration<double, milli>(
+                                                         chrono::steady_clock::now() - start)
+                                                         .count()));
             }
-            break;
+
+            // Дальше углубляться не нужно: достигнут уровень бота или найден выигрыш.
+            if (Max_depth >= target_depth || is_win_score(score))
+                break;
+            time_check = (time_limit_ms > 0);
         }
-        default:
-            // check queens () -    
-            for (POS_T i = -1; i <= 1; i += 2)
+        Max_depth = target_depth;
+        stats.time_ms = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+        return res;
+    }
+
+    /**
+     * @brief Счетчики поиска последнего хода бота.
+     */
+    const SearchStats& last_stats() const
+    {
+        return stats;
+    }
+
+    /**
+     * @brief Ожидаемый ответ соперника по таблице транспозиций последнего поиска:
+     * лучший ход, найденный для позиции после хода бота.
+     * @param pos Позиция, в которой ходит соперник.
+     * @param color Цвет соперника (бот играет другим цветом).
+     * @param reply Сюда записывается ожидаемый ход.
+     * @return bool: false, если позиции нет в таблице.
+     */
+    bool expected_reply(const Position& pos, const bool color, full_turn& reply) const
+    {
+        TTEntry entry;
+        const uint64_t key = position_key(pos, color);
+        // При детерминированном параллельном поиске позиция могла попасть в таблицу одного из потоков.
+        bool found = tt->probe(key, entry);
+        for (size_t t = 0; t < helper_tt.size() && !found; ++t)
+            found = helper_tt[t]->probe(key, entry);
+        if (!found || !entry.move)
+            return false;
+        TurnList turns_now;
+        gen_full_turns(pos, color, turns_now);
+        for (const full_turn& turn : turns_now)
+        {
+            if (turn.code.code == entry.move)
             {
-                for (POS_T j = -1; j <= 1; j += 2)
-                {
-                    //         .
-                    for (POS_T i2 = x + i, j2 = y + j; i2 != 8 && j2 != 8 && i2 != -1 && j2 != -1; i2 += i, j2 += j)
-                    {
-                        if (mtx[i2][j2])
-                            break; //  
-                        turns.emplace_back(x, y, i2, j2);
-                    }
-                }
+                reply = turn;
+                return true;
             }
-            break;
         }
+        return false;
     }
 
-    // ---     ---
+    /**
+     * @brief Переводит копию движка в режим обдумывания на ходу соперника (Game/Ponder.h):
+     * бюджет "BotTimeMS" не действует, поиск прерывается только флагом stop.
+     */
+    void set_ponder(const atomic<bool>* stop)
+    {
+        stop_signal = stop;
+        time_limit_ms = 0;
+    }
+
+    /**
+     * @brief Раскладывает полный ход на шаги для показа на доске.
+     * @param pos Позиция до хода.
+     * @param turn Полный ход, найденный find_best_turn().
+     * @return vector<move_pos> Шаги хода (пусто, если хода нет).
+     */
+    vector<move_pos> turn_steps(const Position& pos, const full_turn& turn) const
+    {
+        vector<move_pos> res;
+        if (turn.code == move_code(0, 0))
+            return res;
+        for (const move_code step : turn_path(pos, turn))
+            res.push_back(to_move_pos(step));
+        return res;
+    }
 
+private:
     /**
-     * @brief   ()    .
-     * @param mtx   .
-     * @param turn   (// ).
-     * @return vector<vector<POS_T>>     .
+     * @brief Одна итерация углубления: выбор специализации поиска по режимам оценки и оптимизации.
+     * Режимы проверяются только здесь, в корне; внутри поиска они - параметры шаблона.
      */
-    vector<vector<POS_T>> make_turn(vector<vector<POS_T>> mtx, move_pos turn) const
+    int search_iteration(Position& pos, const bool color, full_turn& best)
     {
-        if (turn.xb != -1) //    ,  .
-            mtx[turn.xb][turn.yb] = 0;
+        if (scoring_mode == Scoring::NumberAndPotential)
+            return search_iteration<Scoring::NumberAndPotential>(pos, color, best);
+        return search_iteration<Scoring::NumberOnly>(pos, color, best);
+    }
 
-        //     
-        if ((mtx[turn.x][turn.y] == 1 && turn.x2 == 0) || (mtx[turn.x][turn.y] == 2 && turn.x2 == 7))
-            mtx[turn.x][turn.y] += 2; // 1 -> 3 ( ), 2 -> 4 ( )
+    template <Scoring S> int search_iteration(Position& pos, const bool color, full_turn& best)
+    {
+        switch (optimization)
+        {
+        case Optimization::O0:
+            return search_iteration<S, Optimization::O0>(pos, color, best);
+        case Optimization::O2:
+            return search_iteration<S, Optimization::O2>(pos, color, best);
+        default:
+            return search_iteration<S, Optimization::O1>(pos, color, best);
+        }
+    }
 
-        mtx[turn.x2][turn.y2] = mtx[turn.x][turn.y]; //     .
-        mtx[turn.x][turn.y] = 0; //   .
-        return mtx;
+    template <Scoring S, Optimization O> int search_iteration(Position& pos, const bool color, full_turn& best)
+    {
+        if (threads > 1)
+            return find_first_best_turn_parallel<S, O>(pos, color, best);
+        // O2: сначала узкое окно вокруг оценки прошлой итерации - оценка корня обычно меняется мало.
+        // Если оценка вышла за окно, итерация повторяется с полным окном.
+        if constexpr (O == Optimization::O2)
+        {
+            if (Max_depth > 1 && !is_win_score(root_score) && !is_loss_score(root_score))
+            {
+                const int alpha = root_score - ASPIRATION_WINDOW, beta = root_score + ASPIRATION_WINDOW;
+                const int score = find_first_best_turn<S, O>(pos, color, best, alpha, beta);
+                if (stopped || (score > alpha && score < beta))
+                    return score;
+                ++stats.researches;
+            }
+        }
+        return find_first_best_turn<S, O>(pos, color, best, -SCORE_INF, SCORE_INF);
     }
 
     /**
-     * @brief       Minimax .
-     * @param mtx    .
-     * @param first_bot_color  ,      (Max-).
-     * @return double  .     Max-.
+     * @brief Параллельный поиск на первом уровне: ходы корня делятся между потоками.
+     * Каждый поток работает со своей копией Logic (свои таблицы упорядочивания).
+     * Без NoRandom потоки берут ходы по очереди, делят общую таблицу и лучшую оценку для отсечения.
+     * С NoRandom ходы распределены статически, а у каждого потока своя таблица и свое окно,
+     * поэтому результат не зависит от скорости потоков.
+     * @tparam S Режим оценки.
+     * @tparam O Режим оптимизации.
+     * @param pos Позиция корня.
+     * @param color Цвет бота.
+     * @param best Сюда записывается лучший ход.
+     * @return int Оценка лучшего хода для бота.
      */
-    double calc_score(const vector<vector<POS_T>>& mtx, const bool first_bot_color) const
+    template <Scoring S, Optimization O>
+    int find_first_best_turn_parallel(const Position& pos, const bool color, full_turn& best)
     {
-        // color - who is max player
-        double w = 0, wq = 0, b = 0, bq = 0; //    (w),   (wq),  (b),   (bq).
-        for (POS_T i = 0; i < 8; ++i)
+        TurnList root_turns;
+        gen_full_turns(pos, color, root_turns);
+        order_root(root_turns);
+        if (root_turns.empty()) // Позиция - проигрыш (нет ходов)
+            return -SCORE_WIN;
+
+        // Результат хода корня и окно, с которым он считался: оценка не выше alpha - лишь граница.
+        struct RootResult
         {
-            for (POS_T j = 0; j < 8; ++j)
-            {
-                w += (mtx[i][j] == 1);
-                wq += (mtx[i][j] == 3);
-                b += (mtx[i][j] == 2);
-                bq += (mtx[i][j] == 4);
+            int score = -SCORE_INF;
+            int alpha = -SCORE_INF;
+        };
+        vector<RootResult> results(root_turns.size);
+        atomic<size_t> next_turn(0);
+        mutex best_mutex;
+        int shared_best = -SCORE_INF;
 
-                //     ( )
-                if (scoring_mode == "NumberAndPotential")
+        vector<Logic> workers(threads, *this);
+        vector<thread> pool;
+        for (unsigned t = 0; t < threads; ++t)
+        {
+            pool.emplace_back([&, t]() {
+                Logic& w = workers[t];
+                if (no_random)
+                    w.tt = helper_tt[t];
+                w.stats = SearchStats();
+                int local_best = -SCORE_INF;
+                for (size_t k = 0;; ++k)
                 {
-                    //  (1)   0-  (7-i).   i,    .
-                    w += 0.05 * (mtx[i][j] == 1) * (7 - i);
-                    //  (2)   7-  (i).   i,    .
-                    b += 0.05 * (mtx[i][j] == 2) * (i);
+                    const size_t i = (no_random ? t + k * threads : next_turn++);
+                    if (i >= size_t(root_turns.size))
+                        break;
+                    int alpha = local_best;
+                    if (!no_random)
+                    {
+                        lock_guard<mutex> lock(best_mutex);
+                        alpha = shared_best;
+                    }
+                    Position p = pos;
+                    p.make(root_turns[int(i)]);
+                    const int score = -w.find_best_turns_rec<S, O>(p, !color, 1, Max_depth - 1, -SCORE_INF, -alpha);
+                    if (w.stopped)
+                        break;
+
+                    results[i].score = score;
+                    results[i].alpha = alpha;
+                    local_best = max(local_best, score);
+                    if (!no_random)
+                    {
+                        lock_guard<mutex> lock(best_mutex);
+                        shared_best = max(shared_best, score);
+                    }
                 }
-            }
+            });
         }
-
-        // : Max-  "" (b, bq)   .
-        if (!first_bot_color)
+        for (auto& th : pool)
+            th.join();
+        for (auto& w : workers)
         {
-            swap(b, w);
-            swap(bq, wq);
+            stopped = stopped || w.stopped;
+            stats.add(w.stats);
         }
-
-        //  /
-        if (w + wq == 0) // Min- 
-            return INF;
-        if (b + bq == 0) // Max- 
+        ++stats.nodes; // корень
+        if (stopped)
             return 0;
 
-        int q_coef = 4; //   
-        if (scoring_mode == "NumberAndPotential")
+        // Лучший ход - максимальная точная оценка; при равенстве - первый в списке ходов.
+        int best_score = -SCORE_INF;
+        for (size_t i = 0; i < results.size(); ++i)
         {
-            q_coef = 5;
+            if (results[i].score > results[i].alpha && results[i].score > best_score)
+            {
+                best_score = results[i].score;
+                best = root_turns[int(i)];
+            }
         }
-        //    Max-   Min-.
-        //  > 1.0   Max-, < 1.0   Min-.
-        return (b + bq * q_coef) / (w + wq * q_coef);
+        return best_score;
     }
 
-public:
     /**
-     * @brief       .
-     *  find_first_best_turn     .
-     * @param color   (Max-).
-     * @return vector<move_pos>  ,    ( ).
+     * @brief Поиск лучшего хода на первом уровне (корень дерева).
+     * Серия взятий - один полный ход, поэтому корень отличается от остальных узлов
+     * только случайным порядком ходов и тем, что запоминает сам ход.
+     * @param pos Позиция корня.
+     * @param color Цвет бота.
+     * @param best Сюда записывается лучший ход.
+     * @param alpha Нижняя граница окна корня: оценка не выше нее - лишь верхняя граница настоящей.
+     * @param beta Верхняя граница окна корня: оценка не ниже нее - лишь нижняя граница настоящей.
+     * @return int Лучшая оценка для бота.
      */
-    vector<move_pos> find_best_turns(const bool color)
+    template <Scoring S, Optimization O>
+    int find_first_best_turn(Position& pos, const bool color, full_turn& best, const int alpha, const int beta)
     {
-        next_best_state.clear();
-        next_move.clear();
+        ++stats.nodes;
+        TurnList turns_now;
+        gen_full_turns(pos, color, turns_now);
+        // Случайность выбора среди равных ходов - только здесь, на первом уровне.
+        order_root(turns_now);
+        if (turns_now.empty()) // Позиция - проигрыш (нет ходов)
+            return -SCORE_WIN;
 
-        //       0.
-        find_first_best_turn(board->get_board(), color, -1, -1, 0);
-
-        //       (next_best_state).
-        int cur_state = 0;
-        vector<move_pos> res;
-        do
+        int best_score = -SCORE_INF;
+        bool first = true;
+        for (const full_turn& turn : turns_now)
         {
-            res.push_back(next_move[cur_state]);
-            cur_state = next_best_state[cur_state];
-        } while (cur_state != -1 && next_move[cur_state].x != -1);
-        return res;
+            const int window_alpha = max(alpha, best_score);
+            const Undo undo = pos.make(turn);
+            int score;
+            // O2: первый ход - с полным окном, остальные только проверяются нулевым окном, не лучше ли они.
+            if (O == Optimization::O2 && !first)
+            {
+                score = -find_best_turns_rec<S, O>(pos, !color, 1, Max_depth - 1, -window_alpha - 1, -window_alpha);
+                if (score > window_alpha && score < beta && !stopped)
+                {
+                    ++stats.researches;
+                    score = -find_best_turns_rec<S, O>(pos, !color, 1, Max_depth - 1, -beta, -window_alpha);
+                }
+            }
+            else
+                score = -find_best_turns_rec<S, O>(pos, !color, 1, Max_depth - 1, -beta, -window_alpha);
+            pos.unmake(turn, undo);
+            first = false;
+            if (stopped) // Время вышло: результат итерации все равно будет отброшен.
+                return best_score;
+
+            if (score > best_score)
+            {
+                best_score = score;
+                best = turn;
+                // Выигрыш следующим же ходом: лучше хода быть не может.
+                if (O != Optimization::O0 && best_score >= SCORE_WIN - 1)
+                    return best_score;
+                // Оценка не ниже beta: настоящая оценка корня выше окна, итерацию повторят с полным окном.
+                if (best_score >= beta)
+                    return best_score;
+            }
+        }
+        return best_score;
     }
 
-private:
     /**
-     * @brief          .
-     *      ,     ,
-     *     find_best_turns_rec.
-     * @param mtx   .
-     * @param color   .
-     * @param x X- ,   ( -1   ).
-     * @param y Y- ,   ( -1   ).
-     * @param state      next_move/next_best_state.
-     * @param alpha  ,     ( ).
-     * @return double    Max- ().
-     */
-    double find_first_best_turn(vector<vector<POS_T>> mtx, const bool color, const POS_T x, const POS_T y, size_t state,
-        double alpha = -1)
+     * @brief Рекурсивный поиск negamax с alpha-beta отсечением.
+     * Каждый ход - полный (серия взятий целиком), так что каждый уровень - смена игрока.
+     * Оценка всегда с точки зрения игрока, который ходит: оценка хода - минус оценка позиции после него.
+     * @param pos Текущая позиция.
+     * @param color Цвет игрока, который ходит.
+     * @param depth Текущая глубина поиска (начинается с 1 после первого хода).
+     * @param remaining Оставшаяся глубина (0 - лист); обычно Max_depth - depth, меньше - после сокращения (O2).
+     * @param alpha Оценка, которую игрок уже может себе гарантировать.
+     * @param beta Оценка, выше которой соперник не допустит (ход с такой оценкой дает отсечение).
+     * @return int Оценка позиции для игрока color.
+     */
+    template <Scoring S, Optimization O>
+    int find_best_turns_rec(Position& pos, const bool color, const size_t depth, const int remaining, int alpha,
+                            const int beta)
     {
-        //        .
-        next_best_state.push_back(-1);
-        next_move.emplace_back(-1, -1, -1, -1);
-        double best_score = -1;
-
-        // 1.   
-        if (state != 0) //      (state != 0),     .
-            find_turns(x, y, mtx);
-        else //     ,     .
-            find_turns(color, mtx);
-
-        auto turns_now = turns;
-        bool have_beats_now = have_beats;
-
-        // 2.    
-        if (!have_beats_now && state != 0)
-        {
-            //    ,   find_best_turns_rec, 
-            //      Minimax-.
-            return find_best_turns_rec(mtx, 1 - color, 1, alpha, INF + 1);
-        }
+        // Проверка лимита времени; при остановке поиск просто сворачивается, результат не используется.
+        if (out_of_time())
+            return 0;
+        ++stats.nodes;
 
-        if (turns_now.empty()) //  -  ( )
-            return 0; //    Max-.
+        // Позиция из базы эндшпилей: результат известен точно.
+        uint8_t tb_value;
+        if (tablebase->probe(pos, color, tb_value))
+            return tablebase_score(tb_value, depth);
 
-        // 3.    
-        for (auto turn : turns_now)
+        // 1. Базовый случай: Достигнута максимальная глубина.
+        if (remaining <= 0)
         {
-            size_t next_state = next_move.size();
-            double score;
-
-            if (have_beats_now) //     
+            // Если на листе есть обязательное взятие, сначала доигрываем взятия.
+            if (quiescence_limit)
             {
-                //   find_first_best_turn:  Minimax  .
-                score = find_first_best_turn(make_turn(mtx, turn), color, turn.x2, turn.y2, next_state, best_score);
+                quiescence_nodes = 0;
+                return quiescence<S, O>(pos, color, depth, alpha, beta);
             }
-            else //      ( )
+            return leaf_score<S>(pos, color, depth);
+        }
+
+        // 2. Проверка таблицы транспозиций.
+        const int alpha_orig = alpha;
+        constexpr bool use_table = (O != Optimization::O0);
+        const uint64_t key = position_key(pos, color);
+        TTEntry entry;
+        const bool found = use_table && tt->probe(key, entry);
+        stats.tt_probes += use_table;
+        stats.tt_hits += found;
+        if (found && entry.depth >= remaining)
+        {
+            const int score = score_from_tt(entry.score, depth);
+            if (entry.bound == Bound::EXACT || (entry.bound == Bound::LOWER && score >= beta) ||
+                (entry.bound == Bound::UPPER && score <= alpha))
+                return score;
+        }
+
+        // 3. Поиск возможных ходов (в свой список на стеке, без копий)
+        TurnList turns_now;
+        gen_full_turns(pos, color, turns_now);
+
+        // 4. Базовый случай: нет ходов (проигрыш на этой глубине).
+        if (turns_now.empty())
+            return -(SCORE_WIN - int(depth));
+
+        // Упорядочивание: ход из таблицы, ходы-убийцы, затем по истории отсечений.
+        order_turns(turns_now, pos, color, depth, found ? &entry : nullptr);
+
+        int best_score = -SCORE_INF;
+        move_code best_turn(0, 0); // Лучший ход узла для таблицы транспозиций.
+        int turn_index = 0; // Номер хода в порядке перебора (для доли отсечений на первом ходе).
+
+        // 5. Рекурсивный перебор всех возможных ходов.
+        for (const full_turn& turn : turns_now)
+        {
+            const Undo undo = pos.make(turn);
+            // Передача хода другому игроку: его окно - наше, взятое с обратным знаком.
+            int score;
+            if (O == Optimization::O2 && turn_index > 0)
             {
-                //   find_best_turns_rec:  Minimax  (depth = 1).
-                score = find_best_turns_rec(make_turn(mtx, turn), 1 - color, 1, best_score, INF + 1);
+                // Поздний тихий ход (не взятие и не превращение) сначала ищется на 1 полуход мельче.
+                const bool reduce = turn_index >= LMR_FIRST_TURN && remaining >= LMR_MIN_REMAINING &&
+                                    !turn.beaten && !turn.promoted;
+                // Нулевое окно только проверяет, лучше ли ход уже найденного.
+                score = -find_best_turns_rec<S, O>(pos, !color, depth + 1, remaining - 1 - reduce, -alpha - 1,
+                                                   -alpha);
+                if (reduce && score > alpha && !stopped)
+                {
+                    ++stats.researches;
+                    score = -find_best_turns_rec<S, O>(pos, !color, depth + 1, remaining - 1, -alpha - 1, -alpha);
+                }
+                // Ход лучше: его точная оценка ищется с полным окном.
+                if (score > alpha && score < beta && !stopped)
+                {
+                    ++stats.researches;
+                    score = -find_best_turns_rec<S, O>(pos, !color, depth + 1, remaining - 1, -beta, -alpha);
+                }
             }
+            else
+                score = -find_best_turns_rec<S, O>(pos, !color, depth + 1, remaining - 1, -beta, -alpha);
+            pos.unmake(turn, undo); // Возвращаем позицию перед следующим ходом.
+            if (stopped)
+                return 0;
 
-            // 4.      
             if (score > best_score)
             {
                 best_score = score;
-                // ,    :     (next_state)     (-1).
-                next_best_state[state] = (have_beats_now ? int(next_state) : -1);
-                next_move[state] = turn;
-                // Alpha-Beta    
-                if (optimization != "O0" && best_score >= INF) //   ,   .
-                    return INF;
+                best_turn = turn.code;
+            }
+            alpha = max(alpha, best_score);
+
+            // 6. Alpha-Beta отсечение: соперник не допустит позицию, где у нас есть такой ход.
+            if (O != Optimization::O0 && alpha >= beta)
+            {
+                if (!turn.beaten) // Тихий ход, давший отсечение, запоминаем для соседних узлов.
+                    remember_cutoff(turn.code, color, depth, remaining);
+                ++stats.cutoffs;
+                stats.first_cutoffs += (turn_index == 0);
+                break;
             }
+            ++turn_index;
+        }
+
+        if constexpr (use_table)
+        {
+            // Оценка вне исходного окна - лишь граница настоящей оценки.
+            const Bound bound =
+                (best_score <= alpha_orig ? Bound::UPPER : (best_score >= beta ? Bound::LOWER : Bound::EXACT));
+            tt->store(key, remaining, bound, score_to_tt(best_score, depth), best_turn.code);
         }
         return best_score;
     }
 
     /**
-     * @brief     Minimax  Alpha-Beta .
-     * @param mtx   .
-     * @param color  ,   .
-     * @param depth    (  1   ).
-     * @param alpha  () ,  Max-  .
-     * @param beta  () ,  Min-  .
-     * @param x X- ,   (  ).
-     * @param y Y- ,   (  ).
-     * @return double  .
+     * @brief Продолжение поиска за горизонтом только по обязательным взятиям.
+     * Позиция с взятием на ходу не оценивается статически: взятие обязательно,
+     * поэтому перебираются все взятия, пока они есть или пока не исчерпан лимит узлов листа.
+     * @param pos Текущая позиция.
+     * @param color Цвет игрока, чей ход.
+     * @param depth Глубина узла.
+     * @param alpha Нижняя граница окна (для игрока color).
+     * @param beta Верхняя граница окна.
+     * @return int Оценка позиции для игрока color.
      */
-    double find_best_turns_rec(vector<vector<POS_T>> mtx, const bool color, const size_t depth, double alpha = -1,
-        double beta = INF + 1, const POS_T x = -1, const POS_T y = -1)
+    template <Scoring S, Optimization O> int quiescence(Position& pos, const bool color, const size_t depth, int alpha,
+                                                        const int beta)
     {
-        // 1.  :   .
-        if (depth >= Max_depth)
-        {
-            //  . first_bot_color  Max-.
-            return calc_score(mtx, (Max_depth % 2 != color));
-        }
+        TurnList captures;
+        if (quiescence_nodes >= quiescence_limit || !gen_full_turns(pos, color, captures))
+            return leaf_score<S>(pos, color, depth);
+        ++quiescence_nodes;
 
-        // 2.   
-        if (x != -1) //      (  ).
+        int best_score = -SCORE_INF;
+        for (const full_turn& turn : captures)
         {
-            find_turns(x, y, mtx);
-        }
-        else //  :     .
-            find_turns(color, mtx);
+            const Undo undo = pos.make(turn);
+            ++stats.nodes;
+            const int score = -quiescence<S, O>(pos, !color, depth + 1, -beta, -alpha);
+            pos.unmake(turn, undo);
 
-        auto turns_now = turns;
-        bool have_beats_now = have_beats;
-
-        // 3.    .
-        if (!have_beats_now && x != -1)
-        {
-            //    ,      (x!=-1), 
-            //       .
-            return find_best_turns_rec(mtx, 1 - color, depth + 1, alpha, beta);
+            best_score = max(best_score, score);
+            alpha = max(alpha, best_score);
+            if (O != Optimization::O0 && alpha >= beta)
+                break;
         }
+        return best_score;
+    }
 
-        // 4.  :   ().
-        if (turns_now.empty())
-            //   : Max- (depth % 2 == 1)  ( 0). 
-            // Min- (depth % 2 == 0)  ( INF, .. Min-  ).
-            return (depth % 2 ? 0 : INF);
+    /**
+     * @brief Оценка по значению базы эндшпилей: ничья - 0, выигрыш и проигрыш - с расстоянием от корня.
+     * @param value Значение базы для игрока, который ходит.
+     * @param depth Глубина узла.
+     */
+    int tablebase_score(const uint8_t value, const size_t depth) const
+    {
+        if (value == TB_DRAW)
+            return 0;
+        if (tb_is_win(value))
+            return SCORE_WIN - int(depth) - value;
+        return -(SCORE_WIN - int(depth) - (value - TB_LOSS));
+    }
+
+    /**
+     * @brief Оценка для таблицы транспозиций: расстояние до выигрыша считается от узла, а не от корня,
+     * чтобы запись была верна и там, где позиция встретится на другой глубине.
+     */
+    static int score_to_tt(const int score, const size_t depth)
+    {
+        if (is_win_score(score))
+            return score + int(depth);
+        if (is_loss_score(score))
+            return score - int(depth);
+        return score;
+    }
 
-        double min_score = INF + 1; //   Min- (Minimax).
-        double max_score = -1; //   Max- (Minimax).
+    /**
+     * @brief Оценка из таблицы транспозиций для узла на глубине depth (обратно к score_to_tt).
+     */
+    static int score_from_tt(const int score, const size_t depth)
+    {
+        if (is_win_score(score))
+            return score - int(depth);
+        if (is_loss_score(score))
+            return score + int(depth);
+        return score;
+    }
 
-        // 5.     .
-        for (auto turn : turns_now)
+    /**
+     * @brief Выбирает ход корня по базе эндшпилей: самый быстрый выигрыш или самый долгий проигрыш.
+     * Ничейные позиции оставляются поиску: база не отличает в них сильные ходы от слабых.
+     * @param pos Позиция корня.
+     * @param color Цвет бота.
+     * @param best Сюда записывается ход.
+     * @return bool: true, если ход выбран по базе.
+     */
+    bool find_tablebase_turn(const Position& pos, const bool color, full_turn& best) const
+    {
+        uint8_t value;
+        if (!tablebase->probe(pos, color, value) || value == TB_DRAW)
+            return false;
+        TurnList turns_now;
+        gen_full_turns(pos, color, turns_now);
+        int best_rank = -1;
+        for (const full_turn& turn : turns_now)
         {
-            double score = 0.0;
+            Position next = pos;
+            next.make(turn);
+            uint8_t next_value = TB_LOSS; // У соперника не осталось фигур.
+            if (next.pieces(!color) && !tablebase->probe(next, !color, next_value))
+                return false;
+            // Чем быстрее проигрывает соперник и чем дольше выигрывает, тем лучше ход.
+            int rank = TB_LOSS; // ничья
+            if (tb_is_loss(next_value))
+                rank = 2 * TB_LOSS - (next_value - TB_LOSS);
+            else if (tb_is_win(next_value))
+                rank = next_value;
+            if (rank > best_rank)
+            {
+                best_rank = rank;
+                best = turn;
+            }
+        }
+        return best_rank != -1;
+    }
 
-            if (!have_beats_now && x == -1) //   (     ).
+    /**
+     * @brief Выбирает ход по книге дебютов: с NoRandom - самый частый в партиях построения книги,
+     * иначе случайный с вероятностью, пропорциональной частоте.
+     * @param pos Позиция корня.
+     * @param color Цвет бота.
+     * @param best Сюда записывается ход.
+     * @return bool: true, если ход выбран по книге.
+     */
+    bool find_book_turn(const Position& pos, const bool color, full_turn& best)
+    {
+        const BookEntry* entries;
+        const size_t n = book->probe(position_key(pos, color), entries);
+        if (!n)
+            return false;
+        TurnList turns_now;
+        gen_full_turns(pos, color, turns_now);
+        // Записи сверяются с законными ходами: совпадение хэшей разных позиций не даст сыграть чужой ход.
+        full_turn candidates[MAX_TURNS];
+        uint32_t games[MAX_TURNS];
+        int count = 0;
+        uint64_t total = 0;
+        for (size_t i = 0; i < n; ++i)
+        {
+            for (const full_turn& turn : turns_now)
             {
-                //       .
-                score = find_best_turns_rec(make_turn(mtx, turn), 1 - color, depth + 1, alpha, beta);
+                if (turn.code.code == entries[i].move && uint32_t(turn.beaten) == entries[i].beaten)
+                {
+                    candidates[count] = turn;
+                    games[count++] = entries[i].games;
+                    total += entries[i].games;
+                    break;
+                }
+            }
+        }
+        if (!total)
+            return false;
+        int pick = 0;
+        if (no_random)
+        {
+            for (int i = 1; i < count; ++i)
+            {
+                if (games[i] > games[pick])
+                    pick = i;
             }
-            else //     .
+        }
+        else
+        {
+            uint64_t r = uniform_int_distribution<uint64_t>(0, total - 1)(rand_eng);
+            while (r >= games[pick])
+                r -= games[pick++];
+        }
+        best = candidates[pick];
+        return true;
+    }
+
+    /**
+     * @brief Сортирует ходы узла по ожидаемой силе, чтобы отсечения происходили как можно раньше.
+     * Порядок: лучший ход из таблицы транспозиций, два хода-убийцы этой глубины,
+     * взятия дамок, остальные - по таблице истории.
+     * @param turns_now Ходы узла (сортируются на месте).
+     * @param pos Позиция узла.
+     * @param color Цвет игрока, который ходит.
+     * @param depth Глубина узла.
+     * @param entry Запись таблицы транспозиций для узла или nullptr.
+     */
+    void order_turns(TurnList& turns_now, const Position& pos, const bool color, const size_t depth,
+                     const TTEntry* entry) const
+    {
+        if (turns_now.size < 2)
+            return;
+        int keys[MAX_TURNS];
+        for (int i = 0; i < turns_now.size; ++i)
+        {
+            const move_code turn = turns_now[i].code;
+            int key = history[color][turn.from()][turn.to()];
+            if (entry && entry->move == turn.code)
+                key += 1 << 30;
+            else if (depth < MAX_PLY && killers[depth][0] == turn)
+                key += 1 << 29;
+            else if (depth < MAX_PLY && killers[depth][1] == turn)
+                key += 1 << 28;
+            if (pos.kings & turns_now[i].beaten)
+                key += 1 << 27;
+            keys[i] = key;
+        }
+        // Сортировка вставками: ходов в узле немного, а порядок равных сохраняется.
+        for (int i = 1; i < turns_now.size; ++i)
+        {
+            for (int j = i; j > 0 && keys[j - 1] < keys[j]; --j)
             {
-                //      (color)    .
-                score = find_best_turns_rec(make_turn(mtx, turn), color, depth, alpha, beta, turn.x2, turn.y2);
+                swap(keys[j - 1], keys[j]);
+                swap(turns_now[j - 1], turns_now[j]);
             }
+        }
+    }
 
-            //  Minimax 
-            min_score = min(min_score, score);
-            max_score = max(max_score, score);
+    /**
+     * @brief Запоминает тихий ход, давший отсечение: как ход-убийцу глубины и в таблице истории.
+     */
+    void remember_cutoff(const move_code turn, const bool color, const size_t depth, const int remaining)
+    {
+        if (depth < MAX_PLY && killers[depth][0] != turn)
+        {
+            killers[depth][1] = killers[depth][0];
+            killers[depth][0] = turn;
+        }
+        int& value = history[color][turn.from()][turn.to()];
+        value = min(value + remaining * remaining, 1 << 20);
+    }
 
-            // 6. Alpha-Beta 
-            if (depth % 2) // Max- ( ,  ).
-                alpha = max(alpha, max_score);
-            else // Min- ( ,  ).
-                beta = min(beta, min_score);
+    /**
+     * @brief Подготовка таблиц упорядочивания к новому ходу бота:
+     * ходы-убийцы сбрасываются, история уменьшается вдвое, чтобы старые отсечения весили меньше.
+     */
+    void age_ordering()
+    {
+        for (auto& ply : killers)
+            ply[0] = ply[1] = move_code(0, 0);
+        for (auto& side : history)
+            for (auto& from : side)
+                for (int& value : from)
+                    value /= 2;
+    }
 
-            if (optimization != "O0" && alpha >= beta)
+    /**
+     * @brief Случайный порядок ходов корня (при NoRandom генератор фиксирован)
+     * и лучший ход прошлой итерации углубления первым.
+     */
+    void order_root(TurnList& turns_now)
+    {
+        shuffle(turns_now.begin(), turns_now.end(), rand_eng);
+        for (int i = 0; i < turns_now.size; ++i)
+        {
+            if (turns_now[i].code == root_best)
             {
-                // :  alpha >= beta,   ,  Min-    
-                // ( Max-   ),    .
-                return (depth % 2 ? max_score : min_score); //   / .
+                rotate(turns_now.begin(), turns_now.begin() + i, turns_now.begin() + i + 1);
+                break;
             }
         }
+    }
 
-        //   Minimax:   Max-,   Min-.
-        return (depth % 2 ? max_score : min_score);
+    /**
+     * @brief Проверяет, не истек ли бюджет времени на ход и не отменено ли обдумывание
+     * (часы и флаг опрашиваются раз в 1024 узла).
+     * @return bool: true, если поиск нужно прервать.
+     */
+    bool out_of_time()
+    {
+        if ((!time_check && !stop_signal) || stopped)
+            return stopped;
+        if ((++check_nodes & 1023) == 0)
+        {
+            stopped = (time_check && chrono::steady_clock::now() >= deadline) ||
+                      (stop_signal && stop_signal->load(memory_order_relaxed));
+        }
+        return stopped;
     }
 
 private:
-    // ---    ---
+    // --- Приватные поля класса ---
     /**
-     * @brief   ,    .
+     * @brief Генератор случайных чисел, используется для перемешивания ходов.
      */
     default_random_engine rand_eng;
     /**
-     * @brief   ,    (, "NumberAndPotential").
+     * @brief Режим оценки позиции ("BotScoringType").
+     */
+    Scoring scoring_mode = Scoring::NumberOnly;
+    /**
+     * @brief Режим оптимизации поиска ("Optimization").
+     */
+    Optimization optimization = Optimization::O1;
+    /**
+     * @brief Таблица транспозиций; размер задается "HashSizeMB" в настройках.
+     * Общая для копий Logic, которые ищут в других потоках.
+     */
+    shared_ptr<TransTable> tt;
+    /**
+     * @brief Отдельные таблицы потоков для детерминированного параллельного поиска (NoRandom).
+     */
+    vector<shared_ptr<TransTable>> helper_tt;
+    /**
+     * @brief Число потоков поиска ("BotThreads").
+     */
+    unsigned threads = 1;
+    /**
+     * @brief Бот должен играть детерминированно ("NoRandom").
+     */
+    bool no_random = false;
+    /**
+     * @brief Ходы-убийцы: по два тихих хода на глубину, недавно давших отсечение.
+     */
+    move_code killers[MAX_PLY][2];
+    /**
+     * @brief Таблица истории: вес отсечений для [цвет][from][to].
+     */
+    int history[2][32][32] = {};
+    /**
+     * @brief Лучший ход корня с прошлой итерации углубления.
+     */
+    move_code root_best = move_code(0, 0);
+    /**
+     * @brief Оценка корня с прошлой итерации углубления (центр окна O2).
+     */
+    int root_score = 0;
+    /**
+     * @brief Бюджет времени на ход бота в миллисекундах ("BotTimeMS"); 0 - без ограничения.
+     */
+    int time_limit_ms = 0;
+    /**
+     * @brief Момент, после которого текущий поиск должен быть прерван.
+     */
+    chrono::steady_clock::time_point deadline;
+    /**
+     * @brief Включена ли проверка времени (со второй итерации углубления).
+     */
+    bool time_check = false;
+    /**
+     * @brief Флаг прерывания поиска по времени.
+     */
+    bool stopped = false;
+    /**
+     * @brief Счетчик узлов между опросами часов.
+     */
+    size_t check_nodes = 0;
+    /**
+     * @brief Флаг отмены обдумывания на ходу соперника (nullptr - обычный поиск).
+     */
+    const atomic<bool>* stop_signal = nullptr;
+    /**
+     * @brief База эндшпилей ("TablebaseFile"), общая для копий Logic.
      */
-    string scoring_mode;
+    shared_ptr<Tablebase> tablebase;
     /**
-     * @brief   ,    (, "O0", "AB").
+     * @brief Книга дебютов ("BookFile"), общая для копий Logic.
      */
-    string optimization;
+    shared_ptr<Book> book;
     /**
-     * @brief      (   )    ()   .
+     * @brief Лимит узлов продолжения взятий на один лист ("QuiescenceNodes"); 0 - без продолжения.
      */
-    vector<move_pos> next_move;
+    unsigned quiescence_limit = 0;
     /**
-     * @brief         .
-     *    next_move     ().
+     * @brief Узлы продолжения взятий, пройденные от текущего листа.
      */
-    vector<int> next_best_state;
+    unsigned quiescence_nodes = 0;
     /**
-     * @brief     .
+     * @brief Счетчики текущего (последнего) поиска.
      */
-    Board* board;
+    SearchStats stats;
     /**
-     * @brief    .
+     * @brief Указатель на настройки игры.
      */
     Config* config;
 };
\ No newline at end of file
@@ -0,0 +1,118 @@
+#pragma once
+#include <stdint.h>
+#include <string>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/**
+ * @brief Файл, отображенный в память только для чтения (база эндшпилей, книга дебютов).
+ * Файл не читается целиком: система подгружает страницы по мере обращений.
+ */
+class MappedFile
+{
+public:
+    MappedFile() = default;
+
+    ~MappedFile()
+    {
+        unmap();
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    /**
+     * @brief Отображает файл в память (предыдущее отображение закрывается).
+     * @return bool: false, если файла нет или он пустой.
+     */
+    bool map(const std::string& path)
+    {
+        unmap();
+#ifdef _WIN32
+        file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                           FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE)
+            return false;
+        LARGE_INTEGER size;
+        if (!GetFileSizeEx(file, &size) || size.QuadPart == 0)
+            return unmap(), false;
+        file_size = uint64_t(size.QuadPart);
+        mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (!mapping)
+            return unmap(), false;
+        bytes = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+        if (!bytes)
+            return unmap(), false;
+#else
+        const int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+            return false;
+        struct stat st;
+        if (fstat(fd, &st) != 0 || st.st_size == 0)
+        {
+            close(fd);
+            return false;
+        }
+        file_size = uint64_t(st.st_size);
+        void* addr = mmap(nullptr, file_size, PROT_READ, MAP_SHARED, fd, 0);
+        close(fd); // Отображение остается действительным и после закрытия файла.
+        if (addr == MAP_FAILED)
+        {
+            file_size = 0;
+            return false;
+        }
+        bytes = static_cast<const char*>(addr);
+#endif
+        return true;
+    }
+
+    /**
+     * @brief Закрывает отображение.
+     */
+    void unmap()
+    {
+#ifdef _WIN32
+        if (bytes)
+            UnmapViewOfFile(bytes);
+        if (mapping)
+            CloseHandle(mapping);
+        if (file != INVALID_HANDLE_VALUE)
+            CloseHandle(file);
+        mapping = nullptr;
+        file = INVALID_HANDLE_VALUE;
+#else
+        if (bytes)
+            munmap(const_cast<char*>(bytes), file_size);
+#endif
+        bytes = nullptr;
+        file_size = 0;
+    }
+
+    const char* data() const
+    {
+        return bytes;
+    }
+
+    uint64_t size() const
+    {
+        return file_size;
+    }
+
+private:
+    const char* bytes = nullptr;
+    uint64_t file_size = 0;
+#ifdef _WIN32
+    HANDLE file = INVALID_HANDLE_VALUE;
+    HANDLE mapping = nullptr;
+#endif
+};
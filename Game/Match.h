@@ -0,0 +1,81 @@
+#pragma once
+#include <vector>
+
+#include "../Models/Position.h"
+#include "Config.h"
+#include "Logic.h"
+
+/**
+ * @brief Партия бота с ботом без окна и задержек: только позиция и движок.
+ * Правила окончания те же, что в Game::play(): нет ходов - поражение, "MaxNumTurns" ходов - ничья.
+ * Уровни ботов берутся из "WhiteBotLevel" и "BlackBotLevel".
+ */
+class Match
+{
+public:
+    /**
+     * @param config Указатель на настройки (только читаются, поэтому могут быть общими для партий в разных потоках).
+     */
+    explicit Match(Config* config) : config(config), bots{Logic(config), Logic(config)}
+    {
+    }
+
+    /**
+     * @brief Задает seed случайного порядка ходов обоих ботов (без "NoRandom" партии с разным seed различаются).
+     */
+    void seed(const unsigned value)
+    {
+        bots[0].seed(value * 2);
+        bots[1].seed(value * 2 + 1);
+    }
+
+    /**
+     * @brief Играет партию от начальной позиции.
+     * @return int Результат в кодировке Game::play(): 0 - ничья, 1 - победа белых, 2 - победа черных.
+     */
+    int play()
+    {
+        Position pos = start_position();
+        moves.clear();
+        stats = SearchStats();
+        const int max_turns = config->get()->max_num_turns;
+        int turn_num = -1;
+        while (++turn_num < max_turns)
+        {
+            const bool color = turn_num % 2;
+            Logic& logic = bots[color];
+            logic.Max_depth = config->get()->bot_level[color];
+            const full_turn turn = logic.find_best_turn(pos, color);
+            stats.add(logic.last_stats());
+            if (turn.code == move_code(0, 0)) // Нет ходов - поражение того, кто ходит.
+                break;
+            pos.make(turn);
+            moves.push_back(turn);
+        }
+        if (turn_num == max_turns)
+            return 0;
+        return (turn_num % 2 ? 1 : 2);
+    }
+
+    /**
+     * @brief Ходы последней сыгранной партии.
+     */
+    const std::vector<full_turn>& get_moves() const
+    {
+        return moves;
+    }
+
+    /**
+     * @brief Счетчики поиска обоих ботов за последнюю партию.
+     */
+    const SearchStats& get_stats() const
+    {
+        return stats;
+    }
+
+private:
+    Config* config;
+    Logic bots[2]; // Боты белых и черных, у каждого своя таблица транспозиций.
+    std::vector<full_turn> moves;
+    SearchStats stats;
+};
@@ -0,0 +1,306 @@
+#pragma once
+#include <stdint.h>
+#include <string.h>
+#include <stdexcept>
+
+#include "../Models/Move.h"
+#include "../Models/Position.h"
+
+// Наибольшее число ходов в одной позиции, под которое рассчитан список ходов.
+// Обычных ходов не больше 12 * 13, а разных полных взятий дамками бывает больше: поиск отжигом
+// по случайным позициям находит до 278. Если список все же переполнится, add() бросает исключение,
+// а не теряет ход молча.
+const int MAX_TURNS = 384;
+
+/**
+ * @brief Список ходов фиксированной емкости на стеке вызывающего.
+ * Генератор пишет только в переданный ему список, поэтому его можно вызывать
+ * рекурсивно и из нескольких потоков одновременно, без копирований и выделений памяти.
+ */
+template <typename T> struct FixedList
+{
+    T turns[MAX_TURNS];
+    int size = 0;
+
+    void add(const T& turn)
+    {
+        if (size >= MAX_TURNS)
+            throw std::runtime_error("move list overflow: MAX_TURNS is too small for this position");
+        turns[size++] = turn;
+    }
+    bool empty() const
+    {
+        return size == 0;
+    }
+    T& operator[](const int i)
+    {
+        return turns[i];
+    }
+    const T& operator[](const int i) const
+    {
+        return turns[i];
+    }
+    T* begin()
+    {
+        return turns;
+    }
+    T* end()
+    {
+        return turns + size;
+    }
+    const T* begin() const
+    {
+        return turns;
+    }
+    const T* end() const
+    {
+        return turns + size;
+    }
+};
+
+// Шаги: обычные ходы и одиночные взятия (для интерфейса и продолжения серии).
+typedef FixedList<move_code> MoveList;
+// Полные ходы: серия взятий целиком - один ход (для поиска бота).
+typedef FixedList<full_turn> TurnList;
+
+/**
+ * @brief Ищет ходы для всех фигур из маски movers (все фигуры одного цвета).
+ * Шашки обрабатываются сразу всей маской сдвигами, дамки - лучами по диагоналям.
+ * Приоритет отдается взятиям: если есть хотя бы одно, обычные ходы не ищутся.
+ * @param pos Позиция, в которой ищется ход.
+ * @param movers Маска фигур, для которых ищутся ходы.
+ * @param color Цвет фигур (0 - белые, 1 - черные).
+ * @param list Список, в который записываются ходы (очищается).
+ * @return bool: true, если найденные ходы - взятия.
+ */
+inline bool gen_turns(const Position& pos, const BB movers, const bool color, MoveList& list)
+{
+    list.size = 0;
+    const BB opp = pos.pieces(!color);
+    const BB empty = pos.empty();
+    const BB men = movers & ~pos.kings;
+    const BB queens = movers & pos.kings;
+
+    // check beats
+    // Шашки бьют во всех четырех направлениях: через соседнюю фигуру противника на пустую клетку.
+    for (int d = 0; d < 4; ++d)
+    {
+        BB land = bb_shift(bb_shift(men, d) & opp, d) & empty;
+        while (land)
+        {
+            const int to = bb_pop(land);
+            const BB beaten = bb_shift(BB(1) << to, dir_back(d));
+            list.add(move_code(bb_first(bb_shift(beaten, dir_back(d))), to, bb_first(beaten)));
+        }
+    }
+    // Дамки: по диагонали до первой фигуры; если это фигура противника,
+    // то все пустые клетки за ней до следующей фигуры - места приземления.
+    for (BB q = queens; q;)
+    {
+        const int from = bb_pop(q);
+        for (int d = 0; d < 4; ++d)
+        {
+            BB cur = bb_shift(BB(1) << from, d);
+            while (cur & empty)
+                cur = bb_shift(cur, d);
+            if (!(cur & opp))
+                continue;
+            const int beaten = bb_first(cur);
+            for (BB land = bb_shift(cur, d); land & empty; land = bb_shift(land, d))
+                list.add(move_code(from, bb_first(land), beaten));
+        }
+    }
+    if (!list.empty())
+        return true; // Найдено взятие, обычные ходы не нужны.
+
+    // Шашки ходят только вперед: белые (0) к строке 0, черные (1) к строке 7.
+    for (int d = (color ? DOWN_LEFT : UP_LEFT), last = d + 1; d <= last; ++d)
+    {
+        BB to_mask = bb_shift(men, d) & empty;
+        while (to_mask)
+        {
+            const int to = bb_pop(to_mask);
+            list.add(move_code(bb_first(bb_shift(BB(1) << to, dir_back(d))), to));
+        }
+    }
+    // Дамки ходят по диагоналям до первой занятой клетки.
+    for (BB q = queens; q;)
+    {
+        const int from = bb_pop(q);
+        for (int d = 0; d < 4; ++d)
+        {
+            for (BB cur = bb_shift(BB(1) << from, d); cur & empty; cur = bb_shift(cur, d))
+                list.add(move_code(from, bb_first(cur)));
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Ищет все ходы игрока заданного цвета.
+ * @return bool: true, если ходы - обязательные взятия.
+ */
+inline bool gen_turns(const Position& pos, const bool color, MoveList& list)
+{
+    return gen_turns(pos, pos.pieces(color), color, list);
+}
+
+/**
+ * @brief Ищет ходы одной фигуры на клетке sq (продолжение серии взятий).
+ * @return bool: true, если ходы - взятия.
+ */
+inline bool gen_turns_from(const Position& pos, const int sq, MoveList& list)
+{
+    const BB bit = BB(1) << sq;
+    return gen_turns(pos, bit, (pos.black & bit) != 0, list);
+}
+
+/**
+ * @brief Множество законченных серий взятий, уже записанных в список полных ходов:
+ * открытая адресация по итоговой позиции хода, чтобы проверка повтора не перебирала весь список.
+ */
+class CaptureSet
+{
+public:
+    CaptureSet()
+    {
+        memset(slots, 0, sizeof(slots));
+    }
+
+    /**
+     * @brief Ищет ход, равный turn (full_turn::operator==), среди записанных в list.
+     * @return bool: true, если такого хода еще нет; тогда он добавляется в list.
+     */
+    bool insert(const full_turn& turn, TurnList& list)
+    {
+        // Ключ согласован с operator==: дамка, вернувшаяся на свою клетку, дает ту же позицию с любой клетки.
+        const uint32_t squares = (turn.code.from() == turn.code.to())
+                                     ? 0x3FFu
+                                     : uint32_t(turn.code.from() | (turn.code.to() << 5));
+        const uint32_t h = turn.beaten * 0x9E3779B1u ^ (squares | (uint32_t(turn.promoted) << 10)) * 0x85EBCA6Bu;
+        for (uint32_t i = h >> (32 - BITS);; i = (i + 1) & (SIZE - 1))
+        {
+            if (!slots[i])
+            {
+                list.add(turn);
+                slots[i] = uint16_t(list.size);
+                return true;
+            }
+            if (list[slots[i] - 1] == turn)
+                return false;
+        }
+    }
+
+private:
+    static constexpr int BITS = 10;
+    static constexpr int SIZE = 1 << BITS; // не меньше 2 * MAX_TURNS: таблица заполнена не больше чем наполовину
+    static_assert(SIZE >= 2 * MAX_TURNS, "CaptureSet is too small for MAX_TURNS");
+    uint16_t slots[SIZE]; // номер хода в списке + 1; 0 - ячейка пуста
+};
+
+/**
+ * @brief Продолжает серию взятий turn с клетки turn.code.to() до конца всеми способами.
+ * Законченная серия добавляется в список, если такой же итоговой позиции там еще нет.
+ * @param pos Позиция после уже сделанных шагов серии (меняется на время перебора).
+ * @param turn Сделанная часть серии.
+ * @param list Список полных ходов.
+ * @param seen Серии, уже записанные в list.
+ */
+inline void gen_capture_tail(Position& pos, const full_turn& turn, TurnList& list, CaptureSet& seen)
+{
+    MoveList steps;
+    if (!gen_turns_from(pos, turn.code.to(), steps))
+    {
+        // Серия закончена: разные порядки взятий с тем же итогом - один ход.
+        seen.insert(turn, list);
+        return;
+    }
+    for (const move_code step : steps)
+    {
+        const Undo undo = pos.make(step);
+        gen_capture_tail(pos,
+                         {move_code(turn.code.from(), step.to(), turn.code.beaten()),
+                          BB(turn.beaten | (BB(1) << step.beaten())), turn.promoted || undo.promoted},
+                         list, seen);
+        pos.unmake(step, undo);
+    }
+}
+
+/**
+ * @brief Ищет все полные ходы игрока: обычные ходы или серии взятий целиком.
+ * @param pos Позиция, в которой ищется ход.
+ * @param color Цвет игрока (0 - белые, 1 - черные).
+ * @param list Список, в который записываются ходы (очищается).
+ * @return bool: true, если ходы - взятия.
+ */
+inline bool gen_full_turns(const Position& pos, const bool color, TurnList& list)
+{
+    list.size = 0;
+    MoveList steps;
+    if (!gen_turns(pos, color, steps))
+    {
+        const BB last_row = (color ? ROW_7 : ROW_0);
+        for (const move_code step : steps)
+        {
+            const bool promoted = !(pos.kings & (BB(1) << step.from())) && (last_row & (BB(1) << step.to()));
+            list.add({step, 0, promoted});
+        }
+        return false;
+    }
+    Position p = pos;
+    CaptureSet seen;
+    for (const move_code step : steps)
+    {
+        const Undo undo = p.make(step);
+        gen_capture_tail(p, {step, BB(1) << step.beaten(), undo.promoted}, list, seen);
+        p.unmake(step, undo);
+    }
+    return true;
+}
+
+/**
+ * @brief Ищет шаги серии взятий с клетки sq, приводящие к позиции target.
+ * @param pos Текущая позиция (меняется на время перебора).
+ * @param target Позиция после полного хода.
+ * @param beaten Фигуры, битые полным ходом (другие взятия сразу отбрасываются).
+ * @param sq Клетка бьющей фигуры.
+ * @param path Сделанные шаги; при успехе - весь путь.
+ * @return bool: true, если путь найден.
+ */
+inline bool gen_turn_path(Position& pos, const Position& target, const BB beaten, const int sq,
+                          std::vector<move_code>& path)
+{
+    MoveList steps;
+    if (!gen_turns_from(pos, sq, steps))
+        return pos == target;
+    for (const move_code step : steps)
+    {
+        if (!(beaten & (BB(1) << step.beaten())))
+            continue;
+        const Undo undo = pos.make(step);
+        path.push_back(step);
+        const bool found = gen_turn_path(pos, target, beaten, step.to(), path);
+        pos.unmake(step, undo);
+        if (found)
+            return true;
+        path.pop_back();
+    }
+    return false;
+}
+
+/**
+ * @brief Раскладывает полный ход на шаги (для показа хода на доске по одному взятию).
+ * @param pos Позиция до хода.
+ * @param turn Полный ход.
+ * @return std::vector<move_code> Шаги хода.
+ */
+inline std::vector<move_code> turn_path(const Position& pos, const full_turn& turn)
+{
+    if (!turn.beaten)
+        return {turn.code};
+    Position p = pos, target = pos;
+    target.make(turn);
+    std::vector<move_code> path;
+    gen_turn_path(p, target, turn.beaten, turn.code.from(), path);
+    return path;
+}
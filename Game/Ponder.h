@@ -0,0 +1,103 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <memory>
+
+#include "../Models/Position.h"
+#include "Logic.h"
+#include "SearchStats.h"
+
+/**
+ * @brief Обдумывание на ходу человека: пока человек думает, копия движка в фоне ищет ответ бота
+ * на ожидаемый ход человека (лучший ход человека по таблице транспозиций последнего поиска бота).
+ * Если человек сыграл ожидаемый ход, бот берет готовый результат, иначе фоновый поиск отменяется.
+ */
+class Ponder
+{
+public:
+    Ponder() = default;
+    Ponder(const Ponder&) = delete;
+    Ponder& operator=(const Ponder&) = delete;
+
+    ~Ponder()
+    {
+        cancel();
+    }
+
+    /**
+     * @brief Начинает обдумывание, если ответ человека можно предсказать.
+     * @param logic Движок бота (копируется; таблица транспозиций остается общей).
+     * @param pos Позиция, в которой ходит человек.
+     * @param color Цвет человека.
+     * @param bot_depth Уровень бота ("WhiteBotLevel"/"BlackBotLevel").
+     */
+    void start(const Logic& logic, const Position& pos, const bool color, const int bot_depth)
+    {
+        cancel();
+        full_turn reply;
+        if (!logic.expected_reply(pos, color, reply))
+            return;
+        expected = pos;
+        expected.make(reply);
+        bot_color = !color;
+        engine.reset(new Logic(logic));
+        engine->Max_depth = bot_depth;
+        stop = false;
+        engine->set_ponder(&stop);
+        Logic* const search = engine.get();
+        const Position root = expected;
+        const bool search_color = bot_color;
+        result = std::async(std::launch::async, [search, root, search_color]() {
+            return search->find_best_turn(root, search_color);
+        });
+    }
+
+    /**
+     * @brief Забирает результат обдумывания, если человек сыграл ожидаемый ход.
+     * Незаконченный поиск получает еще time_limit_ms (0 - ждать до конца) и отдает ход последней полной итерации.
+     * @param pos Позиция, в которой теперь ходит бот.
+     * @param color Цвет бота.
+     * @param time_limit_ms Бюджет времени на ход бота ("BotTimeMS").
+     * @param best Сюда записывается ход бота.
+     * @param stats Сюда записываются счетчики фонового поиска.
+     * @return bool: false - обдумывания не было или ход не угадан (поиск отменен), ход нужно искать заново.
+     */
+    bool take(const Position& pos, const bool color, const int time_limit_ms, full_turn& best, SearchStats& stats)
+    {
+        if (!result.valid())
+            return false;
+        if (color != bot_color || !(pos == expected))
+        {
+            cancel();
+            return false;
+        }
+        if (time_limit_ms > 0 &&
+            result.wait_for(std::chrono::milliseconds(time_limit_ms)) == std::future_status::timeout)
+            stop = true;
+        best = result.get();
+        stats = engine->last_stats();
+        engine.reset();
+        return best.code != move_code(0, 0);
+    }
+
+    /**
+     * @brief Отменяет обдумывание (ход не угадан, откат хода, перезапуск или выход).
+     */
+    void cancel()
+    {
+        if (result.valid())
+        {
+            stop = true;
+            result.get();
+        }
+        engine.reset();
+    }
+
+private:
+    std::unique_ptr<Logic> engine; // копия движка для фонового поиска
+    Position expected;             // позиция после ожидаемого хода человека
+    bool bot_color = false;
+    std::atomic<bool> stop{false};
+    std::future<full_turn> result;
+};
@@ -0,0 +1,106 @@
+#pragma once
+#include <stdint.h>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "Logger.h"
+
+/**
+ * @brief Счетчики поиска бота: за один ход (Logic::last_stats()) или суммарно за партию.
+ */
+struct SearchStats
+{
+    int turns = 0;               // число ходов бота, вошедших в счетчики
+    uint64_t nodes = 0;          // посещенные узлы (включая продолжение взятий)
+    uint64_t leaves = 0;         // статические оценки позиций (calc_score)
+    uint64_t cutoffs = 0;        // отсечения alpha-beta
+    uint64_t first_cutoffs = 0;  // отсечения на первом же ходе узла (показатель качества упорядочивания)
+    uint64_t tt_probes = 0;      // обращения к таблице транспозиций
+    uint64_t tt_hits = 0;        // позиции, уже встречавшиеся в поиске (найдены в таблице)
+    uint64_t researches = 0;     // повторные поиски после нулевого или узкого окна и сокращения (O2)
+    double time_ms = 0;          // время поиска
+    std::vector<uint64_t> depth_nodes; // узлы каждой итерации углубления (индекс - глубина - 1)
+    const char* source = "search"; // откуда взят ход: "search", "book" или "tablebase" (для одного хода)
+
+    /**
+     * @brief Глубина последней завершенной итерации углубления (0 - ход из книги или базы, без поиска).
+     */
+    int depth() const
+    {
+        return int(depth_nodes.size());
+    }
+
+    /**
+     * @brief Прибавляет счетчики другого поиска (другого потока или другого хода).
+     */
+    void add(const SearchStats& other)
+    {
+        turns += other.turns;
+        nodes += other.nodes;
+        leaves += other.leaves;
+        cutoffs += other.cutoffs;
+        first_cutoffs += other.first_cutoffs;
+        tt_probes += other.tt_probes;
+        tt_hits += other.tt_hits;
+        researches += other.researches;
+        time_ms += other.time_ms;
+        if (depth_nodes.size() < other.depth_nodes.size())
+            depth_nodes.resize(other.depth_nodes.size(), 0);
+        for (size_t i = 0; i < other.depth_nodes.size(); ++i)
+            depth_nodes[i] += other.depth_nodes[i];
+    }
+
+    /**
+     * @brief Строка для лога: узлы, скорость, отсечения, повторные позиции
+     * и эффективный коэффициент ветвления (отношение узлов соседних итераций углубления).
+     */
+    std::string report() const
+    {
+        std::ostringstream out;
+        out.setf(std::ios::fixed);
+        out.precision(1);
+        out << "nodes " << nodes << ", leaves " << leaves << ", " << (time_ms > 0 ? nodes / time_ms : 0.0)
+            << " knodes/sec, cutoffs " << cutoffs << " (first move " << percent(first_cutoffs, cutoffs)
+            << "%), repeated positions " << percent(tt_hits, tt_probes) << "%";
+        if (researches)
+            out << ", re-searches " << researches;
+        if (depth_nodes.size() > 1)
+        {
+            out << ", branching";
+            out.precision(2);
+            for (size_t i = 1; i < depth_nodes.size(); ++i)
+                out << " " << (depth_nodes[i - 1] ? double(depth_nodes[i]) / depth_nodes[i - 1] : 0.0);
+        }
+        return out.str();
+    }
+
+    /**
+     * @brief Те же счетчики полями записи журнала (branching - массив коэффициентов ветвления).
+     */
+    void log_fields(LogLine& line) const
+    {
+        line.field("nodes", nodes)
+            .field("leaves", leaves)
+            .field("knps", time_ms > 0 ? nodes / time_ms : 0.0)
+            .field("cutoffs", cutoffs)
+            .field("first_cutoff_pct", percent(first_cutoffs, cutoffs))
+            .field("tt_hit_pct", percent(tt_hits, tt_probes))
+            .field("researches", researches);
+        std::string branching = "[";
+        for (size_t i = 1; i < depth_nodes.size(); ++i)
+        {
+            char buf[32];
+            snprintf(buf, sizeof(buf), "%s%.2f", i > 1 ? "," : "",
+                     depth_nodes[i - 1] ? double(depth_nodes[i]) / depth_nodes[i - 1] : 0.0);
+            branching += buf;
+        }
+        line.raw_field("branching", branching + "]");
+    }
+
+private:
+    static double percent(const uint64_t part, const uint64_t total)
+    {
+        return total ? 100.0 * part / total : 0.0;
+    }
+};
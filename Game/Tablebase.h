@@ -0,0 +1,262 @@
+#pragma once
+#include <stdint.h>
+#include <string.h>
+#include <string>
+
+#include "../Models/Position.h"
+#include "MappedFile.h"
+
+// Наибольшее число фигур на доске, для которого может быть построена база эндшпилей.
+const int TB_MAX_PIECES = 8;
+
+// Значения базы (один байт на позицию, с точки зрения игрока, который ходит):
+// TB_DRAW - ничья, 1..TB_MAX_DIST - выигрыш за столько полуходов,
+// TB_LOSS + n - проигрыш через n полуходов (TB_LOSS - ходов нет), TB_INVALID - невозможная позиция.
+const uint8_t TB_DRAW = 0;
+const uint8_t TB_MAX_DIST = 125;
+const uint8_t TB_LOSS = 128;
+const uint8_t TB_INVALID = 255;
+
+/**
+ * @brief Значение базы - выигрыш игрока, который ходит.
+ */
+inline bool tb_is_win(const uint8_t value)
+{
+    return value >= 1 && value <= TB_MAX_DIST;
+}
+
+/**
+ * @brief Значение базы - проигрыш игрока, который ходит.
+ */
+inline bool tb_is_loss(const uint8_t value)
+{
+    return value >= TB_LOSS && value != TB_INVALID;
+}
+
+/**
+ * @brief Число сочетаний C(n, k) для n <= 32.
+ */
+inline uint64_t tb_binom(const int n, const int k)
+{
+    static const struct Table
+    {
+        uint64_t c[33][TB_MAX_PIECES + 1];
+        Table()
+        {
+            for (int i = 0; i <= 32; ++i)
+            {
+                c[i][0] = 1;
+                for (int j = 1; j <= TB_MAX_PIECES; ++j)
+                    c[i][j] = (i == 0 ? 0 : c[i - 1][j - 1] + c[i - 1][j]);
+            }
+        }
+    } table;
+    return (k < 0 || k > TB_MAX_PIECES || n < 0) ? 0 : table.c[n][k];
+}
+
+/**
+ * @brief Номер набора клеток среди всех наборов того же размера (колексикографический порядок).
+ */
+inline uint64_t tb_rank(BB squares)
+{
+    uint64_t rank = 0;
+    for (int i = 1; squares; ++i)
+        rank += tb_binom(bb_pop(squares), i);
+    return rank;
+}
+
+/**
+ * @brief Набор из k клеток по его номеру (обратно к tb_rank).
+ */
+inline BB tb_unrank(uint64_t rank, const int k)
+{
+    BB squares = 0;
+    int sq = 31;
+    for (int i = k; i >= 1; --i)
+    {
+        while (tb_binom(sq, i) > rank)
+            --sq;
+        squares |= BB(1) << sq;
+        rank -= tb_binom(sq, i);
+        --sq;
+    }
+    return squares;
+}
+
+/**
+ * @brief Материал позиции: число шашек и дамок каждого цвета. Позиции одного материала образуют класс базы.
+ */
+struct TBMaterial
+{
+    uint8_t wm = 0, wk = 0, bm = 0, bk = 0;
+
+    TBMaterial() = default;
+    TBMaterial(const int wm, const int wk, const int bm, const int bk)
+        : wm(uint8_t(wm)), wk(uint8_t(wk)), bm(uint8_t(bm)), bk(uint8_t(bk))
+    {
+    }
+    explicit TBMaterial(const Position& pos)
+        : TBMaterial(bb_count(pos.white & ~pos.kings), bb_count(pos.white & pos.kings),
+                     bb_count(pos.black & ~pos.kings), bb_count(pos.black & pos.kings))
+    {
+    }
+
+    int pieces() const
+    {
+        return wm + wk + bm + bk;
+    }
+    /**
+     * @brief Число позиций класса (с учетом того, кто ходит), включая невозможные.
+     */
+    uint64_t size() const
+    {
+        return tb_binom(32, wm) * tb_binom(32, wk) * tb_binom(32, bm) * tb_binom(32, bk) * 2;
+    }
+    bool operator==(const TBMaterial& other) const
+    {
+        return wm == other.wm && wk == other.wk && bm == other.bm && bk == other.bk;
+    }
+};
+
+/**
+ * @brief Номер позиции внутри класса ее материала.
+ * @param pos Позиция.
+ * @param color Кто ходит (0 - белые, 1 - черные).
+ */
+inline uint64_t tb_index(const Position& pos, const bool color)
+{
+    const TBMaterial m(pos);
+    uint64_t index = tb_rank(pos.white & ~pos.kings);
+    index = index * tb_binom(32, m.wk) + tb_rank(pos.white & pos.kings);
+    index = index * tb_binom(32, m.bm) + tb_rank(pos.black & ~pos.kings);
+    index = index * tb_binom(32, m.bk) + tb_rank(pos.black & pos.kings);
+    return index * 2 + color;
+}
+
+/**
+ * @brief Позиция по номеру внутри класса (обратно к tb_index).
+ * @param m Материал класса.
+ * @param index Номер позиции.
+ * @param pos Сюда записывается позиция (хэш и слагаемые оценки не считаются).
+ * @param color Сюда записывается, кто ходит.
+ * @return bool: false, если номер задает невозможную позицию (фигуры на одной клетке, шашка на последней строке).
+ */
+inline bool tb_position(const TBMaterial& m, uint64_t index, Position& pos, bool& color)
+{
+    color = index & 1;
+    index /= 2;
+    const BB bk = tb_unrank(index % tb_binom(32, m.bk), m.bk);
+    index /= tb_binom(32, m.bk);
+    const BB bm = tb_unrank(index % tb_binom(32, m.bm), m.bm);
+    index /= tb_binom(32, m.bm);
+    const BB wk = tb_unrank(index % tb_binom(32, m.wk), m.wk);
+    const BB wm = tb_unrank(index / tb_binom(32, m.wk), m.wm);
+    if ((wm & wk) || ((wm | wk) & (bm | bk)) || (bm & bk) || (wm & ROW_0) || (bm & ROW_7))
+        return false;
+    pos = Position();
+    pos.white = wm | wk;
+    pos.black = bm | bk;
+    pos.kings = wk | bk;
+    return true;
+}
+
+// Формат файла базы: заголовок, таблица классов, затем значения всех классов подряд (байт на позицию).
+struct TBHeader
+{
+    char magic[4];       // "CTB1"
+    uint32_t max_pieces; // база построена для позиций не более чем с max_pieces фигурами
+    uint32_t classes;    // число записей TBClass после заголовка
+    uint32_t reserved;
+};
+
+struct TBClass
+{
+    TBMaterial material;
+    uint32_t reserved;
+    uint64_t offset; // смещение значений класса от начала файла
+    uint64_t size;   // число позиций класса
+};
+
+/**
+ * @brief База эндшпилей, отображенная в память только для чтения.
+ * Файл не читается целиком: система подгружает страницы по мере обращений,
+ * а копии Logic в разных потоках делят одно отображение.
+ */
+class Tablebase
+{
+public:
+    Tablebase() = default;
+
+    /**
+     * @brief Открывает файл базы; если файла нет или он поврежден, база остается пустой.
+     * @param path Путь к файлу, построенному tb_gen.
+     */
+    explicit Tablebase(const std::string& path)
+    {
+        if (!path.empty() && file.map(path) && !read_index())
+            file.unmap();
+    }
+
+    Tablebase(const Tablebase&) = delete;
+    Tablebase& operator=(const Tablebase&) = delete;
+
+    /**
+     * @brief Наибольшее число фигур в позициях базы (0 - база не загружена).
+     */
+    int max_pieces() const
+    {
+        return pieces;
+    }
+
+    /**
+     * @brief Ищет позицию в базе.
+     * @param pos Позиция.
+     * @param color Кто ходит.
+     * @param value Сюда записывается значение (TB_DRAW, выигрыш или проигрыш с расстоянием).
+     * @return bool: true, если позиция есть в базе.
+     */
+    bool probe(const Position& pos, const bool color, uint8_t& value) const
+    {
+        if (bb_count(pos.white | pos.black) > pieces || !pos.white || !pos.black)
+            return false;
+        const TBMaterial m(pos);
+        const uint64_t offset = class_offset[m.wm][m.wk][m.bm][m.bk];
+        if (!offset)
+            return false;
+        value = uint8_t(file.data()[offset + tb_index(pos, color)]);
+        return value != TB_INVALID;
+    }
+
+private:
+    /**
+     * @brief Проверяет заголовок и заполняет class_offset по таблице классов.
+     * @return bool: false, если файл не является базой или поврежден.
+     */
+    bool read_index()
+    {
+        TBHeader header;
+        if (file.size() < sizeof(header))
+            return false;
+        memcpy(&header, file.data(), sizeof(header));
+        if (memcmp(header.magic, "CTB1", 4) != 0 || header.max_pieces > TB_MAX_PIECES ||
+            file.size() < sizeof(header) + uint64_t(header.classes) * sizeof(TBClass))
+            return false;
+        for (uint32_t i = 0; i < header.classes; ++i)
+        {
+            TBClass cls;
+            memcpy(&cls, file.data() + sizeof(header) + i * sizeof(TBClass), sizeof(cls));
+            const TBMaterial& m = cls.material;
+            if (m.pieces() > int(header.max_pieces) || cls.size != m.size() ||
+                cls.offset > file.size() || cls.size > file.size() - cls.offset) // без переполнения суммы
+                return false;
+            class_offset[m.wm][m.wk][m.bm][m.bk] = cls.offset;
+        }
+        pieces = int(header.max_pieces);
+        return true;
+    }
+
+    MappedFile file;
+    int pieces = 0;
+    // Смещение значений класса по материалу [wm][wk][bm][bk]; 0 - класса нет в файле.
+    uint64_t class_offset[TB_MAX_PIECES + 1][TB_MAX_PIECES + 1][TB_MAX_PIECES + 1][TB_MAX_PIECES + 1] = {};
+};
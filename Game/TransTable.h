@@ -0,0 +1,120 @@
+#pragma once
+#include <atomic>
+#include <memory>
+#include <stdint.h>
+
+// Тип оценки, сохраненной в таблице: точная, нижняя или верхняя граница.
+enum class Bound : uint8_t
+{
+    EXACT, // оценка найдена внутри окна (alpha, beta)
+    LOWER, // произошло отсечение сверху: настоящая оценка не меньше сохраненной
+    UPPER  // ни один ход не улучшил окно: настоящая оценка не больше сохраненной
+};
+
+/**
+ * @brief Запись таблицы транспозиций (копия, возвращаемая probe()).
+ */
+struct TTEntry
+{
+    uint64_t key = 0;     // полный ключ Зобриста узла (0 - пустая запись)
+    int32_t score = 0;    // оценка узла
+    int8_t depth = -1;    // оставшаяся глубина, с которой получена оценка
+    Bound bound = Bound::EXACT;
+    uint16_t move = 0;    // лучший ход (упакованный move_code, 0 - нет хода)
+};
+
+/**
+ * @brief Таблица транспозиций фиксированного размера с прямой адресацией по ключу Зобриста.
+ * Позволяет не пересчитывать позиции, к которым поиск пришел разными порядками ходов.
+ * Таблица без блокировок: в слоте хранится key ^ data, поэтому запись,
+ * разорванная одновременной записью из другого потока, просто не совпадет по ключу.
+ */
+class TransTable
+{
+public:
+    TransTable() = default;
+
+    /**
+     * @brief Создает таблицу размером не больше size_mb мегабайт (число записей - степень двойки).
+     * @param size_mb Размер таблицы в мегабайтах; 0 отключает таблицу.
+     */
+    explicit TransTable(const size_t size_mb)
+    {
+        const size_t max_entries = size_mb * 1024 * 1024 / sizeof(Slot);
+        if (max_entries == 0)
+            return;
+        size_t entries = 1;
+        while (entries * 2 <= max_entries)
+            entries *= 2;
+        table.reset(new Slot[entries]);
+        size = entries;
+        mask = entries - 1;
+        clear();
+    }
+
+    TransTable(const TransTable&) = delete;
+    TransTable& operator=(const TransTable&) = delete;
+
+    /**
+     * @brief Очищает все записи таблицы.
+     */
+    void clear()
+    {
+        for (size_t i = 0; i < size; ++i)
+        {
+            table[i].check.store(0, std::memory_order_relaxed);
+            table[i].data.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * @brief Ищет запись по ключу.
+     * @param key Ключ узла.
+     * @param entry Сюда копируется найденная запись.
+     * @return bool: true, если позиция есть в таблице.
+     */
+    bool probe(const uint64_t key, TTEntry& entry) const
+    {
+        if (!size)
+            return false;
+        const Slot& slot = table[key & mask];
+        const uint64_t data = slot.data.load(std::memory_order_relaxed);
+        if ((slot.check.load(std::memory_order_relaxed) ^ data) != key)
+            return false;
+        entry.key = key;
+        entry.depth = int8_t(data);
+        entry.bound = Bound(uint8_t(data >> 8));
+        entry.move = uint16_t(data >> 16);
+        entry.score = int32_t(uint32_t(data >> 32));
+        return true;
+    }
+
+    /**
+     * @brief Сохраняет результат поиска узла.
+     * Запись другой позиции всегда вытесняется, запись той же позиции - только при не меньшей глубине.
+     */
+    void store(const uint64_t key, const int depth, const Bound bound, const int32_t score, const uint16_t move)
+    {
+        if (!size)
+            return;
+        Slot& slot = table[key & mask];
+        TTEntry old;
+        if (probe(key, old) && old.depth > depth)
+            return;
+        const uint64_t data = uint64_t(uint8_t(depth)) | (uint64_t(uint8_t(bound)) << 8) |
+                              (uint64_t(move) << 16) | (uint64_t(uint32_t(score)) << 32);
+        slot.check.store(key ^ data, std::memory_order_relaxed);
+        slot.data.store(data, std::memory_order_relaxed);
+    }
+
+private:
+    struct Slot
+    {
+        std::atomic<uint64_t> check; // key ^ data
+        std::atomic<uint64_t> data;  // глубина, тип границы, лучший ход и оценка
+    };
+
+    std::unique_ptr<Slot[]> table;
+    size_t size = 0;
+    size_t mask = 0;
+};
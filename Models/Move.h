@@ -1,5 +1,6 @@
 #pragma once
 #include <stdlib.h>
+#include <stdint.h>
 
 // Определение типа для координат на доске. Используется int8_t для экономии памяти, так как координаты 0-7.
 typedef int8_t POS_T;
@@ -33,3 +34,48 @@ struct move_pos
         return !(*this == other);
     }
 };
+
+// Ход, упакованный в 16 бит, для поиска бота. Клетки - номера 0-31 (см. Models/Position.h):
+// биты 0-4 - откуда, 5-9 - куда, 10-14 - битая фигура, 15 - признак взятия.
+// Нулевой код (ход с клетки 0 на клетку 0) означает "нет хода".
+struct move_code
+{
+    uint16_t code;
+
+    // Конструктор по умолчанию не инициализирует код, чтобы списки ходов на стеке ничего не стоили.
+    move_code() = default;
+    move_code(const int from, const int to, const int beaten = -1)
+        : code(uint16_t(from | (to << 5) | (beaten != -1 ? (beaten << 10) | 0x8000 : 0)))
+    {
+    }
+
+    // Номер начальной клетки.
+    int from() const
+    {
+        return code & 31;
+    }
+    // Номер конечной клетки.
+    int to() const
+    {
+        return (code >> 5) & 31;
+    }
+    // Номер клетки битой фигуры или -1, если взятия нет.
+    int beaten() const
+    {
+        return (code & 0x8000) ? (code >> 10) & 31 : -1;
+    }
+    // Является ли ход взятием.
+    bool is_beat() const
+    {
+        return (code & 0x8000) != 0;
+    }
+
+    bool operator==(const move_code& other) const
+    {
+        return code == other.code;
+    }
+    bool operator!=(const move_code& other) const
+    {
+        return code != other.code;
+    }
+};
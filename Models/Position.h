@@ -0,0 +1,483 @@
+#pragma once
+#include <stdint.h>
+#include <string.h>
+#include <vector>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+#include "Move.h"
+
+// Битовая маска на 32 игровых (тёмных) клетках доски.
+// Клетка (x, y) имеет номер x * 4 + y / 2, где x - строка, y - столбец.
+typedef uint32_t BB;
+
+/**
+ * @brief Количество установленных битов в маске.
+ */
+inline int bb_count(BB b)
+{
+#ifdef _MSC_VER
+    return int(__popcnt(b));
+#else
+    return __builtin_popcount(b);
+#endif
+}
+
+/**
+ * @brief Номер младшего установленного бита (маска не должна быть пустой).
+ */
+inline int bb_first(BB b)
+{
+#ifdef _MSC_VER
+    unsigned long idx;
+    _BitScanForward(&idx, b);
+    return int(idx);
+#else
+    return __builtin_ctz(b);
+#endif
+}
+
+/**
+ * @brief Извлекает и удаляет младший установленный бит, возвращая номер клетки.
+ */
+inline int bb_pop(BB& b)
+{
+    int sq = bb_first(b);
+    b &= b - 1;
+    return sq;
+}
+
+// Маски строк и крайних столбцов в 32-клеточной нумерации.
+const BB EVEN_ROWS = 0x0F0F0F0F; // строки 0, 2, 4, 6 (тёмные клетки в нечётных столбцах)
+const BB ODD_ROWS = 0xF0F0F0F0;  // строки 1, 3, 5, 7 (тёмные клетки в чётных столбцах)
+const BB ROW_0 = 0x0000000F;     // последняя строка для белых
+const BB ROW_7 = 0xF0000000;     // последняя строка для чёрных
+
+// Направления по диагонали: вверх (к строке 0) и вниз (к строке 7), влево и вправо.
+enum Dir
+{
+    UP_LEFT,
+    UP_RIGHT,
+    DOWN_LEFT,
+    DOWN_RIGHT
+};
+
+/**
+ * @brief Сдвигает все клетки маски на одну клетку в направлении d.
+ * Из чётных и нечётных строк соседние клетки отстоят на разное число битов,
+ * поэтому сдвиг собирается из двух половин; клетки за краем доски отбрасываются.
+ */
+inline BB bb_shift(const BB b, const int d)
+{
+    switch (d)
+    {
+    case UP_LEFT:
+        return ((b & EVEN_ROWS) >> 4) | ((b & 0xE0E0E0E0) >> 5);
+    case UP_RIGHT:
+        return ((b & 0x07070707) >> 3) | ((b & ODD_ROWS) >> 4);
+    case DOWN_LEFT:
+        return ((b & EVEN_ROWS) << 4) | ((b & 0xE0E0E0E0) << 3);
+    default:
+        return ((b & 0x07070707) << 5) | ((b & ODD_ROWS) << 4);
+    }
+}
+
+/**
+ * @brief Направление, противоположное d.
+ */
+inline int dir_back(const int d)
+{
+    return 3 - d;
+}
+
+/**
+ * @brief Номер клетки (0-31) по координатам тёмной клетки.
+ */
+inline int sq_index(const POS_T x, const POS_T y)
+{
+    return x * 4 + y / 2;
+}
+
+/**
+ * @brief Строка клетки по её номеру.
+ */
+inline POS_T sq_x(const int sq)
+{
+    return POS_T(sq >> 2);
+}
+
+/**
+ * @brief Столбец клетки по её номеру.
+ */
+inline POS_T sq_y(const int sq)
+{
+    return POS_T(2 * (sq & 3) + !((sq >> 2) & 1));
+}
+
+/**
+ * @brief Упаковывает ход в координатах доски в 16-битный код.
+ */
+inline move_code to_move_code(const move_pos& turn)
+{
+    return move_code(sq_index(turn.x, turn.y), sq_index(turn.x2, turn.y2),
+                     turn.xb != -1 ? sq_index(turn.xb, turn.yb) : -1);
+}
+
+/**
+ * @brief Распаковывает 16-битный код хода в координаты доски.
+ */
+inline move_pos to_move_pos(const move_code turn)
+{
+    const int beaten = turn.beaten();
+    if (beaten == -1)
+        return move_pos(sq_x(turn.from()), sq_y(turn.from()), sq_x(turn.to()), sq_y(turn.to()));
+    return move_pos(sq_x(turn.from()), sq_y(turn.from()), sq_x(turn.to()), sq_y(turn.to()), sq_x(beaten),
+                    sq_y(beaten));
+}
+
+/**
+ * @brief Случайные ключи Зобриста: по ключу на каждую пару (клетка, тип фигуры 1-4)
+ * и ключ стороны, которая ходит.
+ * Ключи фиксированы (генерируются из константного seed), чтобы хэши совпадали между запусками.
+ */
+struct Zobrist
+{
+    uint64_t piece[32][5];
+    uint64_t side;
+
+    Zobrist()
+    {
+        uint64_t seed = 0x9E3779B97F4A7C15ull;
+        // splitmix64: простой генератор с хорошим перемешиванием битов.
+        auto next = [&seed]() {
+            uint64_t z = (seed += 0x9E3779B97F4A7C15ull);
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+            return z ^ (z >> 31);
+        };
+        for (int sq = 0; sq < 32; ++sq)
+        {
+            piece[sq][0] = 0;
+            for (int type = 1; type <= 4; ++type)
+                piece[sq][type] = next();
+        }
+        side = next();
+    }
+};
+
+/**
+ * @brief Общая таблица ключей Зобриста.
+ */
+inline const Zobrist& zobrist()
+{
+    static const Zobrist keys;
+    return keys;
+}
+
+/**
+ * @brief Таблица "фигура-клетка" для позиционного слагаемого оценки, [клетка][тип 0-4], в единицах оценки
+ * (100 - шашка), с точки зрения владельца фигуры. Сейчас это продвижение шашки к превращению:
+ * 5 за каждую пройденную строку (белые идут к 0-й строке, черные - к 7-й); дамки и пустая клетка - 0.
+ */
+struct PieceSquare
+{
+    int16_t value[32][5];
+
+    PieceSquare()
+    {
+        for (int sq = 0; sq < 32; ++sq)
+        {
+            const int row = sq >> 2;
+            value[sq][0] = value[sq][3] = value[sq][4] = 0;
+            value[sq][1] = int16_t(5 * (7 - row));
+            value[sq][2] = int16_t(5 * row);
+        }
+    }
+};
+
+/**
+ * @brief Общая таблица "фигура-клетка".
+ */
+inline const PieceSquare& piece_square()
+{
+    static const PieceSquare table;
+    return table;
+}
+
+/**
+ * @brief Запись для отмены хода: что было снято с доски и было ли превращение в дамку.
+ */
+struct Undo
+{
+    BB beaten = 0;        // клетки битых фигур
+    BB beaten_kings = 0;  // какие из битых фигур были дамками
+    bool promoted = false; // ходившая шашка стала дамкой
+};
+
+/**
+ * @brief Полный ход для поиска бота: обычный ход или вся серия взятий одной шашкой.
+ * Серия хранится только начальной и конечной клеткой и маской битых фигур,
+ * поэтому разные порядки взятий, ведущие к одной позиции, - это один ход.
+ */
+struct full_turn
+{
+    move_code code;  // откуда, конечная клетка и первая битая фигура (опознает ход при упорядочивании)
+    BB beaten;       // все фигуры, битые за ход
+    bool promoted;   // шашка стала дамкой по ходу серии
+
+    // Ходы равны, если ведут к одной позиции (первая битая фигура не важна).
+    // Дамки, вернувшиеся на свои клетки после одних и тех же взятий, тоже дают одну позицию.
+    bool operator==(const full_turn& other) const
+    {
+        const bool same_squares = (code.from() == other.code.from() && code.to() == other.code.to()) ||
+                                  (code.from() == code.to() && other.code.from() == other.code.to());
+        return same_squares && beaten == other.beaten && promoted == other.promoted;
+    }
+};
+
+/**
+ * @brief Позиция на доске в виде битовых масок.
+ * Используется логикой бота вместо матрицы 8x8: копирование стоит несколько десятков байт,
+ * поиск ходов выполняется сдвигами масок, а слагаемые оценки ведутся по ходу make()/unmake().
+ */
+struct Position
+{
+    BB white = 0; // белые шашки и дамки
+    BB black = 0; // чёрные шашки и дамки
+    BB kings = 0; // дамки обоих цветов
+    uint64_t hash = 0; // ключ Зобриста расстановки, обновляется в make()/unmake()
+    // Слагаемые оценки, обновляются в make()/unmake() вместе с hash:
+    uint8_t count[5] = {};     // число фигур каждого типа (индекс - тип 1-4, как в Board::mtx)
+    int16_t psq[2] = {};       // сумма значений таблицы "фигура-клетка" (piece_square) белых и черных
+
+    Position() = default;
+
+    /**
+     * @brief Строит позицию по матрице доски (0 - пусто, 1/2 - шашки, 3/4 - дамки).
+     * @param mtx Матрица доски, как в Board::get_board().
+     */
+    explicit Position(const std::vector<std::vector<POS_T>>& mtx)
+    {
+        for (POS_T i = 0; i < 8; ++i)
+        {
+            for (POS_T j = 0; j < 8; ++j)
+            {
+                if (!mtx[i][j])
+                    continue;
+                BB bit = BB(1) << sq_index(i, j);
+                if (mtx[i][j] % 2)
+                    white |= bit;
+                else
+                    black |= bit;
+                if (mtx[i][j] > 2)
+                    kings |= bit;
+            }
+        }
+        update_hash();
+    }
+
+    /**
+     * @brief Пересчитывает ключ Зобриста и слагаемые оценки по маскам (после того как маски заданы напрямую).
+     */
+    void update_hash()
+    {
+        hash = 0;
+        memset(count, 0, sizeof(count));
+        memset(psq, 0, sizeof(psq));
+        for (BB b = white | black; b;)
+        {
+            const int sq = bb_pop(b);
+            add_piece(sq, get(sq));
+        }
+    }
+
+    /**
+     * @brief Учитывает фигуру в ключе и слагаемых оценки (маски не меняет).
+     */
+    void add_piece(const int sq, const POS_T type)
+    {
+        hash ^= zobrist().piece[sq][type];
+        ++count[type];
+        psq[1 - (type & 1)] += piece_square().value[sq][type]; // нечетные типы - белые
+    }
+
+    /**
+     * @brief Убирает фигуру из ключа и слагаемых оценки (маски не меняет).
+     */
+    void remove_piece(const int sq, const POS_T type)
+    {
+        hash ^= zobrist().piece[sq][type];
+        --count[type];
+        psq[1 - (type & 1)] -= piece_square().value[sq][type];
+    }
+
+    /**
+     * @brief Преобразует позицию обратно в матрицу доски.
+     */
+    std::vector<std::vector<POS_T>> to_mtx() const
+    {
+        std::vector<std::vector<POS_T>> mtx(8, std::vector<POS_T>(8, 0));
+        for (int sq = 0; sq < 32; ++sq)
+            mtx[sq_x(sq)][sq_y(sq)] = get(sq);
+        return mtx;
+    }
+
+    /**
+     * @brief Тип фигуры на клетке в кодировке Board::mtx (0 - пусто, 1-4 - типы шашек).
+     */
+    POS_T get(const int sq) const
+    {
+        BB bit = BB(1) << sq;
+        if (!((white | black) & bit))
+            return 0;
+        return POS_T(((white & bit) ? 1 : 2) + ((kings & bit) ? 2 : 0));
+    }
+
+    /**
+     * @brief Маска фигур игрока (0 - белые, 1 - чёрные).
+     */
+    BB pieces(const bool color) const
+    {
+        return color ? black : white;
+    }
+
+    /**
+     * @brief Маска пустых клеток.
+     */
+    BB empty() const
+    {
+        return ~(white | black);
+    }
+
+    /**
+     * @brief Выполняет ход на месте: фигура переходит с from на to, фигуры из beaten снимаются.
+     * Клетки from и to могут совпадать (дамка вернулась на исходную клетку по ходу серии).
+     * @param from Номер начальной клетки.
+     * @param to Номер конечной клетки.
+     * @param beaten Маска битых фигур.
+     * @param promote Шашка становится дамкой (для дамки игнорируется).
+     * @return Undo Данные для отмены хода через unmake().
+     */
+    Undo make(const int from, const int to, const BB beaten, const bool promote)
+    {
+        Undo undo;
+        const BB from_bit = BB(1) << from, to_bit = BB(1) << to;
+        const POS_T type = get(from);
+        BB& own = (type % 2 ? white : black);
+        const bool was_king = (kings & from_bit) != 0;
+        remove_piece(from, type);
+        own &= ~from_bit;
+        kings &= ~from_bit;
+        if (beaten) // Снимаем битые фигуры.
+        {
+            undo.beaten = beaten;
+            undo.beaten_kings = kings & beaten;
+            for (BB b = beaten; b;)
+            {
+                const int sq = bb_pop(b);
+                remove_piece(sq, get(sq));
+            }
+            white &= ~beaten;
+            black &= ~beaten;
+            kings &= ~beaten;
+        }
+        own |= to_bit;
+        if (was_king || promote)
+            kings |= to_bit;
+        undo.promoted = !was_king && promote;
+        add_piece(to, get(to));
+        return undo;
+    }
+
+    /**
+     * @brief Отменяет ход, выполненный make() с теми же клетками.
+     * @param from Номер начальной клетки.
+     * @param to Номер конечной клетки.
+     * @param undo Данные, возвращенные make().
+     */
+    void unmake(const int from, const int to, const Undo& undo)
+    {
+        const BB from_bit = BB(1) << from, to_bit = BB(1) << to;
+        const POS_T type = get(to);
+        const bool is_white = type % 2;
+        const bool was_king = (kings & to_bit) && !undo.promoted;
+        remove_piece(to, type);
+        (is_white ? white : black) &= ~to_bit;
+        kings &= ~to_bit;
+        (is_white ? white : black) |= from_bit;
+        if (was_king)
+            kings |= from_bit;
+        if (undo.beaten) // Возвращаем битые фигуры противнику.
+        {
+            (is_white ? black : white) |= undo.beaten;
+            kings |= undo.beaten_kings;
+            for (BB b = undo.beaten; b;)
+            {
+                const int sq = bb_pop(b);
+                add_piece(sq, get(sq));
+            }
+        }
+        add_piece(from, get(from));
+    }
+
+    /**
+     * @brief Выполняет один шаг (обычный ход или одно взятие); шашка на последней строке становится дамкой.
+     */
+    Undo make(const move_code turn)
+    {
+        const bool last_row = ((BB(1) << turn.to()) & ((white >> turn.from()) & 1 ? ROW_0 : ROW_7)) != 0;
+        return make(turn.from(), turn.to(), turn.is_beat() ? BB(1) << turn.beaten() : 0, last_row);
+    }
+
+    /**
+     * @brief Отменяет шаг, выполненный make(turn).
+     */
+    void unmake(const move_code turn, const Undo& undo)
+    {
+        unmake(turn.from(), turn.to(), undo);
+    }
+
+    /**
+     * @brief Выполняет полный ход (всю серию взятий сразу).
+     */
+    Undo make(const full_turn& turn)
+    {
+        return make(turn.code.from(), turn.code.to(), turn.beaten, turn.promoted);
+    }
+
+    /**
+     * @brief Отменяет полный ход, выполненный make(turn).
+     */
+    void unmake(const full_turn& turn, const Undo& undo)
+    {
+        unmake(turn.code.from(), turn.code.to(), undo);
+    }
+
+    bool operator==(const Position& other) const
+    {
+        return white == other.white && black == other.black && kings == other.kings;
+    }
+};
+
+/**
+ * @brief Ключ позиции с учетом стороны, которая ходит: общий для таблицы транспозиций и книги дебютов
+ * (книга, записанная Tools/book_gen, ищется в игре по тому же ключу).
+ */
+inline uint64_t position_key(const Position& pos, const bool color)
+{
+    return pos.hash ^ (color ? zobrist().side : 0);
+}
+
+/**
+ * @brief Начальная расстановка, как в Board::make_start_mtx(): чёрные шашки на строках 0-2, белые - на 5-7.
+ */
+inline Position start_position()
+{
+    Position pos;
+    pos.black = 0x00000FFF;
+    pos.white = 0xFFF00000;
+    pos.update_hash();
+    return pos;
+}
@@ -0,0 +1,196 @@
+#pragma once
+#include <stdint.h>
+#include <algorithm>
+#include <array>
+#include <utility>
+#include <vector>
+
+#include "Position.h"
+
+// Шаг хода на доске, упакованный в 32 бита (клетки - номера 0-31, см. Models/Position.h):
+// биты 0-4 - откуда, 5-9 - куда, 10-14 - битая фигура, 15 - признак взятия, 16-18 - тип битой фигуры (1-4),
+// 19 - превращение в дамку, 20-24 - номер взятия в серии (0 - ход без взятия).
+// Шаг содержит все, что нужно для отмены и повтора без копии доски.
+struct history_step
+{
+    uint32_t code;
+
+    history_step(const int from, const int to, const int beaten, const POS_T captured, const bool promoted,
+                 const int series)
+        : code(uint32_t(from | (to << 5) | (beaten != -1 ? (beaten << 10) | 0x8000 | (captured << 16) : 0) |
+                        (promoted << 19) | (series < 31 ? series : 31) << 20))
+    {
+    }
+
+    // Номер начальной клетки.
+    int from() const
+    {
+        return code & 31;
+    }
+    // Номер конечной клетки.
+    int to() const
+    {
+        return (code >> 5) & 31;
+    }
+    // Номер клетки битой фигуры или -1, если взятия нет.
+    int beaten() const
+    {
+        return (code & 0x8000) ? (code >> 10) & 31 : -1;
+    }
+    // Тип битой фигуры (1-4) или 0, если взятия нет.
+    POS_T captured() const
+    {
+        return POS_T((code >> 16) & 7);
+    }
+    // Стала ли шашка дамкой на этом шаге.
+    bool promoted() const
+    {
+        return (code >> 19) & 1;
+    }
+    // Номер взятия в серии (0 - ход без взятия, 1 - первое взятие хода и т.д.).
+    int series() const
+    {
+        return (code >> 20) & 31;
+    }
+};
+
+/**
+ * @brief Журнал ходов партии: упакованные шаги (4 байта на шаг) и редкие контрольные точки - полные расстановки.
+ * Ход целиком (серия взятий - один ход) отменяется и повторяется применением своих шагов к доске
+ * за время, не зависящее от длины партии; отмененные шаги хранятся для повтора до следующего нового шага.
+ */
+class UndoLog
+{
+public:
+    // Контрольная точка сохраняется раз в столько шагов (для восстановления доски на любом шаге, board_at).
+    static constexpr size_t CHECKPOINT_STEPS = 64;
+
+    /**
+     * @brief Начинает журнал новой партии.
+     * @param mtx Начальная расстановка (первая контрольная точка).
+     */
+    void reset(const std::vector<std::vector<POS_T>>& mtx)
+    {
+        steps.clear();
+        checkpoints.clear();
+        applied = 0;
+        checkpoints.emplace_back(0, pack(mtx));
+    }
+
+    /**
+     * @brief Записывает сделанный на доске шаг; отмененные шаги после него больше не повторить.
+     * @param step Шаг.
+     * @param mtx Доска после шага.
+     */
+    void push(const history_step step, const std::vector<std::vector<POS_T>>& mtx)
+    {
+        steps.erase(steps.begin() + applied, steps.end());
+        while (checkpoints.size() > 1 && checkpoints.back().first > applied)
+            checkpoints.pop_back();
+        steps.push_back(step);
+        ++applied;
+        if (applied % CHECKPOINT_STEPS == 0 && checkpoints.back().first != applied)
+            checkpoints.emplace_back(applied, pack(mtx));
+    }
+
+    /**
+     * @brief Число сделанных (не отмененных) шагов.
+     */
+    size_t size() const
+    {
+        return applied;
+    }
+
+    /**
+     * @brief Отменяет последний ход целиком: столько последних шагов, каков номер взятия последнего шага (минимум один).
+     * @param mtx Доска, на которой отменяются шаги.
+     */
+    void undo_turn(std::vector<std::vector<POS_T>>& mtx)
+    {
+        if (applied == 0)
+            return;
+        int count = std::max(1, steps[applied - 1].series());
+        while (count-- && applied > 0)
+            undo(steps[--applied], mtx);
+    }
+
+    /**
+     * @brief Повторяет следующий отмененный ход целиком (шаг и продолжения его серии взятий).
+     * @param mtx Доска, на которой повторяются шаги.
+     * @return bool: false, если повторять нечего.
+     */
+    bool redo_turn(std::vector<std::vector<POS_T>>& mtx)
+    {
+        if (applied == steps.size())
+            return false;
+        redo(steps[applied++], mtx);
+        while (applied < steps.size() && steps[applied].series() > 1)
+            redo(steps[applied++], mtx);
+        return true;
+    }
+
+    /**
+     * @brief Восстанавливает доску после первых index шагов: от ближайшей контрольной точки вперед
+     * (не больше CHECKPOINT_STEPS шагов).
+     * @param index Число шагов (не больше числа записанных).
+     * @param mtx Сюда записывается доска.
+     */
+    void board_at(const size_t index, std::vector<std::vector<POS_T>>& mtx) const
+    {
+        size_t cp = checkpoints.size() - 1;
+        while (checkpoints[cp].first > index)
+            --cp;
+        unpack(checkpoints[cp].second, mtx);
+        for (size_t i = checkpoints[cp].first; i < index && i < steps.size(); ++i)
+            redo(steps[i], mtx);
+    }
+
+private:
+    typedef std::array<POS_T, 32> Packed; // фигуры на 32 игровых клетках
+
+    static Packed pack(const std::vector<std::vector<POS_T>>& mtx)
+    {
+        Packed packed;
+        for (int sq = 0; sq < 32; ++sq)
+            packed[sq] = mtx[sq_x(sq)][sq_y(sq)];
+        return packed;
+    }
+
+    static void unpack(const Packed& packed, std::vector<std::vector<POS_T>>& mtx)
+    {
+        mtx.assign(8, std::vector<POS_T>(8, 0));
+        for (int sq = 0; sq < 32; ++sq)
+            mtx[sq_x(sq)][sq_y(sq)] = packed[sq];
+    }
+
+    static POS_T& at(std::vector<std::vector<POS_T>>& mtx, const int sq)
+    {
+        return mtx[sq_x(sq)][sq_y(sq)];
+    }
+
+    static void redo(const history_step step, std::vector<std::vector<POS_T>>& mtx)
+    {
+        POS_T piece = at(mtx, step.from());
+        at(mtx, step.from()) = 0;
+        if (step.beaten() != -1)
+            at(mtx, step.beaten()) = 0;
+        if (step.promoted())
+            piece += 2; // 1->3, 2->4
+        at(mtx, step.to()) = piece;
+    }
+
+    static void undo(const history_step step, std::vector<std::vector<POS_T>>& mtx)
+    {
+        POS_T piece = at(mtx, step.to());
+        at(mtx, step.to()) = 0;
+        if (step.promoted())
+            piece -= 2;
+        at(mtx, step.from()) = piece;
+        if (step.beaten() != -1)
+            at(mtx, step.beaten()) = step.captured();
+    }
+
+    std::vector<history_step> steps;                    // все записанные шаги, включая отмененные
+    size_t applied = 0;                                 // число сделанных шагов (остальные - для повтора)
+    std::vector<std::pair<size_t, Packed>> checkpoints; // (число шагов, расстановка после них)
+};
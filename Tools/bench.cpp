@@ -0,0 +1,97 @@
+// Сравнение режимов поиска "O1" и "O2" на одинаковой глубине: узлы, время и совпадение выбранных ходов.
+// Использование: bench [depth] [positions]
+// Позиции - начальная и полученные случайными ходами из нее (генератор с фиксированным seed,
+// так что набор одинаков от запуска к запуску). Книга, база эндшпилей, потоки и лимит времени отключаются,
+// остальные настройки бота (оценка, продолжение взятий, таблица) берутся из settings.json.
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "../Game/Logic.h"
+
+using namespace std;
+
+/**
+ * @brief Результат поиска одной позиции в одном режиме.
+ */
+struct BenchResult
+{
+    uint64_t nodes = 0;
+    double ms = 0;
+    full_turn turn{move_code(0, 0), 0, false};
+};
+
+BenchResult search(Config& config, const string& mode, const Position& pos, const bool color, const int depth)
+{
+    config.set("Bot", "Optimization", mode);
+    Logic logic(&config);
+    logic.Max_depth = depth;
+    BenchResult res;
+    res.turn = logic.find_best_turn(pos, color);
+    res.nodes = logic.last_stats().nodes;
+    res.ms = logic.last_stats().time_ms;
+    return res;
+}
+
+int main(int argc, char* argv[])
+{
+    const int depth = (argc > 1 ? atoi(argv[1]) : 12);
+    const int count = (argc > 2 ? atoi(argv[2]) : 20);
+    if (depth < 1 || count < 1)
+    {
+        cerr << "usage: bench [depth] [positions]\n";
+        return 1;
+    }
+    Config config;
+    config.set("Bot", "NoRandom", true);
+    config.set("Bot", "BookFile", "");
+    config.set("Bot", "TablebaseFile", "");
+    config.set("Bot", "BotThreads", 1);
+    config.set("Bot", "BotTimeMS", 0);
+
+    vector<pair<Position, bool>> positions;
+    positions.emplace_back(start_position(), false);
+    mt19937 rng(12345);
+    while (int(positions.size()) < count)
+    {
+        Position pos = start_position();
+        bool color = false;
+        const int plies = 4 + int(rng() % 20);
+        for (int ply = 0; ply < plies; ++ply)
+        {
+            TurnList turns;
+            gen_full_turns(pos, color, turns);
+            if (turns.empty())
+                break;
+            pos.make(turns[int(rng() % turns.size)]);
+            color = !color;
+        }
+        TurnList turns;
+        gen_full_turns(pos, color, turns);
+        if (!turns.empty()) // Позиции, где партия уже кончилась, не подходят.
+            positions.emplace_back(pos, color);
+    }
+
+    BenchResult total[2];
+    int same = 0;
+    for (size_t i = 0; i < positions.size(); ++i)
+    {
+        const BenchResult o1 = search(config, "O1", positions[i].first, positions[i].second, depth);
+        const BenchResult o2 = search(config, "O2", positions[i].first, positions[i].second, depth);
+        same += (o1.turn == o2.turn);
+        cout << "position " << i + 1 << ": O1 " << o1.nodes << " nodes " << int(o1.ms) << " ms, O2 " << o2.nodes
+             << " nodes " << int(o2.ms) << " ms" << (o1.turn == o2.turn ? "" : ", other move") << "\n";
+        total[0].nodes += o1.nodes;
+        total[0].ms += o1.ms;
+        total[1].nodes += o2.nodes;
+        total[1].ms += o2.ms;
+    }
+    cout << "depth " << depth << ", " << positions.size() << " positions\n";
+    cout << "O1: " << total[0].nodes << " nodes, " << int(total[0].ms) << " ms\n";
+    cout << "O2: " << total[1].nodes << " nodes, " << int(total[1].ms) << " ms ("
+         << int(100.0 * total[1].nodes / max<uint64_t>(total[0].nodes, 1)) << "% of O1 nodes, "
+         << int(100.0 * total[1].ms / max(total[0].ms, 1e-3)) << "% of O1 time), same move in " << same << " of "
+         << positions.size() << "\n";
+    return 0;
+}
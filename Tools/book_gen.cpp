@@ -0,0 +1,121 @@
+// Построение книги дебютов по партиям бота с ботом.
+// Использование: book_gen [games] [plies] [level] [file] [-t threads] [-m min_games]
+// Партии играются полностью (лимит ходов - "MaxNumTurns") на уровне level за обе стороны;
+// в книгу попадают первые plies ходов каждой партии со статистикой результатов.
+// Остальные настройки бота берутся из settings.json; случайность включается всегда, иначе все партии одинаковы.
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "../Game/Book.h"
+#include "../Game/Match.h"
+
+using namespace std;
+
+int main(int argc, char* argv[])
+{
+    const int games = (argc > 1 ? atoi(argv[1]) : 1000);
+    const int plies = (argc > 2 ? atoi(argv[2]) : 12);
+    const int level = (argc > 3 ? atoi(argv[3]) : 8);
+    const string path = (argc > 4 && argv[4][0] != '-' ? argv[4] : "book.bin");
+    unsigned threads = 0;
+    uint32_t min_games = 2;
+    for (int i = 1; i + 1 < argc; ++i)
+    {
+        const string flag = argv[i];
+        if (flag == "-t")
+            threads = unsigned(atoi(argv[i + 1]));
+        else if (flag == "-m")
+            min_games = uint32_t(atoi(argv[i + 1]));
+    }
+    if (threads == 0)
+        threads = max(1u, thread::hardware_concurrency());
+    if (games < 1 || plies < 1 || level < 1)
+    {
+        cerr << "usage: book_gen [games] [plies] [level] [file] [-t threads] [-m min_games]\n";
+        return 1;
+    }
+
+    Config config;
+    config.set("Bot", "NoRandom", false);
+    config.set("Bot", "BookFile", ""); // Книга строится заново, старая не должна влиять на партии.
+    config.set("Bot", "BotTimeMS", 0);
+    config.set("Bot", "BotThreads", 1); // Потоки делят между собой партии.
+    config.set("Bot", "WhiteBotLevel", level);
+    config.set("Bot", "BlackBotLevel", level);
+
+    vector<BookEntry> played; // по записи на каждый ход книги в каждой партии
+    mutex played_mutex;
+    atomic<int> next_game(0), done(0);
+    vector<thread> pool;
+    for (unsigned t = 0; t < threads; ++t)
+    {
+        pool.emplace_back([&]() {
+            for (int game = next_game++; game < games; game = next_game++)
+            {
+                Match match(&config);
+                match.seed(unsigned(game));
+                const int res = match.play();
+                vector<BookEntry> entries;
+                Position pos = start_position();
+                for (int ply = 0; ply < plies && ply < int(match.get_moves().size()); ++ply)
+                {
+                    const bool color = ply % 2;
+                    const full_turn& turn = match.get_moves()[ply];
+                    BookEntry entry = {};
+                    entry.key = position_key(pos, color);
+                    entry.move = turn.code.code;
+                    entry.beaten = uint32_t(turn.beaten);
+                    entry.games = 1;
+                    // Результат партии (0 - ничья, 1 - победа белых, 2 - победа черных) для сделавшего ход.
+                    entry.score = (res == 0 ? 1 : (res == 1 + color ? 2 : 0));
+                    entries.push_back(entry);
+                    pos.make(turn);
+                }
+                lock_guard<mutex> lock(played_mutex);
+                played.insert(played.end(), entries.begin(), entries.end());
+                if (++done % 100 == 0)
+                    cout << done << " games\n";
+            }
+        });
+    }
+    for (auto& th : pool)
+        th.join();
+
+    // Одинаковые ходы из одинаковых позиций сливаются; редкие ходы отбрасываются.
+    sort(played.begin(), played.end());
+    vector<BookEntry> book;
+    for (const BookEntry& entry : played)
+    {
+        if (!book.empty() && !(book.back() < entry))
+        {
+            book.back().games += entry.games;
+            book.back().score += entry.score;
+        }
+        else
+            book.push_back(entry);
+    }
+    book.erase(remove_if(book.begin(), book.end(), [min_games](const BookEntry& e) { return e.games < min_games; }),
+               book.end());
+    uint64_t positions = 0;
+    for (size_t i = 0; i < book.size(); ++i)
+        positions += (i == 0 || book[i].key != book[i - 1].key);
+
+    BookHeader header;
+    memcpy(header.magic, "CBK1", 4);
+    header.entries = uint32_t(book.size());
+    ofstream fout(path, ios_base::binary | ios_base::trunc);
+    fout.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    fout.write(reinterpret_cast<const char*>(book.data()), book.size() * sizeof(BookEntry));
+    if (!fout)
+    {
+        cerr << "failed to write " << path << "\n";
+        return 1;
+    }
+    cout << "written " << path << ": " << positions << " positions, " << book.size() << " moves\n";
+    return 0;
+}
@@ -0,0 +1,89 @@
+// Проверка журнала: несколько потоков пишут записи, пока главный поток закрывает и заново открывает журнал.
+// Использование: log_check [rounds] [threads] [dir]
+// После каждой записи поток запоминает, сколько раз журнал был закрыт к ее окончанию. Запись, законченная
+// до окончания close(), не должна попасть в файл, открытый после него: иначе она пережила закрытие в очереди.
+// Кроме того, каждая строка каждого файла должна разбираться как JSON. Код возврата 1 - найдена ошибка.
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <thread>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+#include "../Game/Logger.h"
+
+using namespace std;
+
+int main(int argc, char* argv[])
+{
+    const int rounds = (argc > 1 ? atoi(argv[1]) : 200);
+    const int threads = (argc > 2 ? atoi(argv[2]) : 4);
+    const string dir = (argc > 3 ? string(argv[3]) + "/" : string());
+    if (rounds < 1 || threads < 1)
+    {
+        cerr << "usage: log_check [rounds] [threads] [dir]\n";
+        return 1;
+    }
+
+    atomic<int> closes(0);
+    atomic<bool> done(false);
+    vector<vector<int>> closes_after(threads); // [поток][seq]: число закрытий после возврата из write
+    vector<thread> pool;
+    for (int t = 0; t < threads; ++t)
+    {
+        pool.emplace_back([&, t]() {
+            for (uint64_t seq = 0; !done; ++seq)
+            {
+                LogLine line(LogLevel::Info, "check");
+                line.field("thread", t).field("seq", seq);
+                line.field("nan", numeric_limits<double>::quiet_NaN()); // должно записаться как null
+                logger().write(line);
+                closes_after[t].push_back(closes.load());
+            }
+        });
+    }
+    // Файл k открывается после k-го закрытия журнала.
+    for (int k = 0; k < rounds; ++k)
+    {
+        logger().open(dir + "log_check_" + to_string(k) + ".txt", LogLevel::Info);
+        this_thread::sleep_for(chrono::milliseconds(1));
+        logger().close();
+        closes.fetch_add(1);
+    }
+    done = true;
+    for (auto& th : pool)
+        th.join();
+
+    uint64_t lines = 0, stale = 0, broken = 0;
+    for (int k = 0; k < rounds; ++k)
+    {
+        const string path = dir + "log_check_" + to_string(k) + ".txt";
+        ifstream fin(path);
+        string text;
+        while (getline(fin, text))
+        {
+            ++lines;
+            const nlohmann::json record = nlohmann::json::parse(text, nullptr, false);
+            if (record.is_discarded() || !record.is_object())
+            {
+                ++broken;
+                continue;
+            }
+            if (record.value("event", "") != "check")
+                continue;
+            if (!record["nan"].is_null())
+                ++broken;
+            // Запись закончилась до того, как закрылся файл k - 1, а оказалась в файле k.
+            if (closes_after[record["thread"].get<int>()][record["seq"].get<size_t>()] < k)
+                ++stale;
+        }
+        fin.close();
+        remove(path.c_str());
+    }
+    cout << rounds << " files, " << lines << " lines, " << stale << " records from before close, " << broken
+         << " lines that are not JSON\n";
+    return (stale || broken) ? 1 : 0;
+}
@@ -0,0 +1,178 @@
+// Perft: подсчет листьев дерева ходов на заданную глубину для проверки и замера генератора ходов.
+// Использование: perft <depth> [-f file] [-t threads]
+// Без файла считается начальная позиция (ходят белые). В файле - по позиции на строку:
+// 32 цифры типов фигур на тёмных клетках в порядке номеров клеток (0 - пусто, 1/2 - шашки, 3/4 - дамки,
+// как в Board::mtx), затем через пробел, кто ходит: w или b. Пустые строки и строки с # пропускаются.
+// Ход - полный ход бота: серия взятий считается одним ходом, серии с одинаковым итогом - одним.
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../Game/MoveGen.h"
+
+using namespace std;
+
+/**
+ * @brief Число листьев дерева полных ходов глубины depth.
+ */
+uint64_t perft(Position& pos, const bool color, const int depth)
+{
+    TurnList turns;
+    gen_full_turns(pos, color, turns);
+    if (depth == 1)
+        return uint64_t(turns.size);
+    uint64_t nodes = 0;
+    for (const full_turn& turn : turns)
+    {
+        const Undo undo = pos.make(turn);
+        nodes += perft(pos, !color, depth - 1);
+        pos.unmake(turn, undo);
+    }
+    return nodes;
+}
+
+/**
+ * @brief Запись хода для вывода: клетки в координатах доски (строка, столбец) и число битых фигур.
+ */
+string turn_name(const full_turn& turn)
+{
+    ostringstream out;
+    out << int(sq_x(turn.code.from())) << int(sq_y(turn.code.from())) << (turn.beaten ? 'x' : '-')
+        << int(sq_x(turn.code.to())) << int(sq_y(turn.code.to()));
+    if (bb_count(turn.beaten) > 1)
+        out << " (" << bb_count(turn.beaten) << " beaten)";
+    return out.str();
+}
+
+/**
+ * @brief Разбирает строку файла позиций.
+ * @return bool: false, если строка не задает позицию.
+ */
+bool parse_position(const string& line, Position& pos, bool& color)
+{
+    istringstream in(line);
+    string squares, side;
+    if (!(in >> squares >> side) || squares.size() != 32 || (side != "w" && side != "b"))
+        return false;
+    pos = Position();
+    for (int sq = 0; sq < 32; ++sq)
+    {
+        const int type = squares[sq] - '0';
+        if (type < 0 || type > 4)
+            return false;
+        if (!type)
+            continue;
+        const BB bit = BB(1) << sq;
+        (type % 2 ? pos.white : pos.black) |= bit;
+        if (type > 2)
+            pos.kings |= bit;
+    }
+    pos.update_hash();
+    color = (side == "b");
+    return true;
+}
+
+/**
+ * @brief Считает perft позиции с разбивкой по ходам корня; ходы корня делятся между потоками.
+ * @return uint64_t Общее число листьев.
+ */
+uint64_t run(const Position& pos, const bool color, const int depth, const unsigned threads)
+{
+    TurnList root;
+    gen_full_turns(pos, color, root);
+    vector<uint64_t> counts(root.size, 0);
+    atomic<int> next_turn(0);
+    vector<thread> pool;
+    for (unsigned t = 0; t < threads; ++t)
+    {
+        pool.emplace_back([&]() {
+            for (int i = next_turn++; i < root.size; i = next_turn++)
+            {
+                Position p = pos;
+                p.make(root[i]);
+                counts[i] = (depth == 1 ? 1 : perft(p, !color, depth - 1));
+            }
+        });
+    }
+    for (auto& th : pool)
+        th.join();
+    uint64_t total = 0;
+    for (int i = 0; i < root.size; ++i)
+    {
+        cout << "  " << turn_name(root[i]) << ": " << counts[i] << "\n";
+        total += counts[i];
+    }
+    return total;
+}
+
+int main(int argc, char* argv[])
+{
+    if (argc < 2 || atoi(argv[1]) < 1)
+    {
+        cerr << "usage: perft <depth> [-f file] [-t threads]\n";
+        return 1;
+    }
+    const int depth = atoi(argv[1]);
+    string file;
+    unsigned threads = 1;
+    for (int i = 2; i + 1 < argc; i += 2)
+    {
+        const string flag = argv[i];
+        if (flag == "-f")
+            file = argv[i + 1];
+        else if (flag == "-t")
+            threads = unsigned(atoi(argv[i + 1]));
+    }
+    if (threads == 0)
+        threads = max(1u, thread::hardware_concurrency());
+
+    vector<pair<Position, bool>> positions;
+    if (file.empty())
+        positions.emplace_back(start_position(), false);
+    else
+    {
+        ifstream fin(file);
+        if (!fin)
+        {
+            cerr << "cannot open " << file << "\n";
+            return 1;
+        }
+        string line;
+        for (int line_num = 1; getline(fin, line); ++line_num)
+        {
+            if (line.empty() || line[0] == '#')
+                continue;
+            Position pos;
+            bool color;
+            if (!parse_position(line, pos, color))
+            {
+                cerr << file << ":" << line_num << ": bad position\n";
+                return 1;
+            }
+            positions.emplace_back(pos, color);
+        }
+    }
+
+    uint64_t all_nodes = 0;
+    double all_ms = 0;
+    for (size_t i = 0; i < positions.size(); ++i)
+    {
+        cout << "position " << i + 1 << ", depth " << depth << ":\n";
+        const auto start = chrono::steady_clock::now();
+        const uint64_t nodes = run(positions[i].first, positions[i].second, depth, threads);
+        const double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+        cout << "  nodes " << nodes << ", " << int(ms) << " ms, " << uint64_t(nodes / max(ms, 1e-3) * 1000)
+             << " nodes/sec\n";
+        all_nodes += nodes;
+        all_ms += ms;
+    }
+    if (positions.size() > 1)
+        cout << "total nodes " << all_nodes << ", " << int(all_ms) << " ms, "
+             << uint64_t(all_nodes / max(all_ms, 1e-3) * 1000) << " nodes/sec\n";
+    return 0;
+}
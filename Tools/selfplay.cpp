@@ -0,0 +1,54 @@
+// Партии бота с ботом без окна (для серверов без дисплея): движок работает на полной скорости.
+// Использование: selfplay [games] [-t threads]
+// Настройки ботов берутся из settings.json (раздел "Bot"), лимит ходов - из "MaxNumTurns".
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "../Game/Match.h"
+
+using namespace std;
+
+int main(int argc, char* argv[])
+{
+    const int games = (argc > 1 ? atoi(argv[1]) : 1);
+    unsigned threads = 1;
+    if (argc > 3 && string(argv[2]) == "-t")
+        threads = unsigned(atoi(argv[3]));
+    if (threads == 0)
+        threads = max(1u, thread::hardware_concurrency());
+
+    Config config;
+    int results[3] = {};
+    atomic<int> next_game(0);
+    mutex out_mutex;
+    const auto start = chrono::steady_clock::now();
+    vector<thread> pool;
+    for (unsigned t = 0; t < threads; ++t)
+    {
+        pool.emplace_back([&]() {
+            for (int game = next_game++; game < games; game = next_game++)
+            {
+                Match match(&config);
+                match.seed(unsigned(game));
+                const auto game_start = chrono::steady_clock::now();
+                const int res = match.play();
+                const double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - game_start).count();
+                lock_guard<mutex> lock(out_mutex);
+                ++results[res];
+                cout << "game " << game + 1 << ": " << (res == 0 ? "draw" : (res == 1 ? "white wins" : "black wins"))
+                     << ", " << match.get_moves().size() << " turns, " << int(ms) << " ms\n"
+                     << "  search: " << match.get_stats().report() << "\n";
+            }
+        });
+    }
+    for (auto& th : pool)
+        th.join();
+    const double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+    cout << "white " << results[1] << ", black " << results[2] << ", draws " << results[0] << ", " << int(ms)
+         << " ms\n";
+    return 0;
+}
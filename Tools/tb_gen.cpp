@@ -0,0 +1,188 @@
+// Построение базы эндшпилей для бота.
+// Использование: tb_gen [max_pieces] [file]
+// По умолчанию строятся позиции до 4 фигур в файл tablebase.bin (его читает Logic, см. "TablebaseFile").
+// Все классы держатся в памяти по байту на позицию, а шашки индексируются по всем 32 клеткам,
+// поэтому построение ограничено TB_GEN_MAX_PIECES фигурами (5 фигур - около 0.5 ГБ, 6 - уже около 11 ГБ).
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include "../Game/MoveGen.h"
+#include "../Game/Tablebase.h"
+
+using namespace std;
+
+// Все построенные классы: материал и значения позиций.
+struct BuiltClass
+{
+    TBMaterial material;
+    vector<uint8_t> values;
+};
+
+// Наибольшее число фигур, для которого построение помещается в память.
+const int TB_GEN_MAX_PIECES = 5;
+
+vector<BuiltClass> built;
+// Номер построенного класса в built по материалу [wm][wk][bm][bk]; -1 - класс еще не построен.
+int built_index[TB_GEN_MAX_PIECES + 1][TB_GEN_MAX_PIECES + 1][TB_GEN_MAX_PIECES + 1][TB_GEN_MAX_PIECES + 1];
+
+/**
+ * @brief Значения уже построенного класса по материалу (поиск по таблице, без перебора классов).
+ */
+const vector<uint8_t>& find_class(const TBMaterial& m)
+{
+    return built[built_index[m.wm][m.wk][m.bm][m.bk]].values;
+}
+
+/**
+ * @brief Новое значение позиции по значениям позиций после каждого ее хода.
+ * Выигрыш - если есть ход в проигрыш соперника (берется самый быстрый),
+ * проигрыш - если все ходы ведут в выигрыш соперника (берется самый долгий), иначе пока ничья.
+ * @param m Материал строящегося класса.
+ * @param cur Значения класса с прошлого прохода.
+ */
+uint8_t solve(const TBMaterial& m, const vector<uint8_t>& cur, const Position& pos, const bool color)
+{
+    TurnList turns;
+    gen_full_turns(pos, color, turns);
+    if (turns.empty())
+        return TB_LOSS;
+    int best_win = TB_MAX_DIST + 2, longest_loss = 0;
+    bool all_lose = true;
+    for (const full_turn& turn : turns)
+    {
+        Position next = pos;
+        next.make(turn);
+        uint8_t value;
+        if (!next.pieces(!color))
+            value = TB_LOSS; // У соперника не осталось фигур.
+        else
+        {
+            const TBMaterial nm(next);
+            const vector<uint8_t>& values = (nm == m ? cur : find_class(nm));
+            value = values[tb_index(next, !color)];
+        }
+        if (tb_is_loss(value))
+            best_win = min(best_win, min(value - TB_LOSS + 1, TB_MAX_DIST + 1));
+        else if (tb_is_win(value))
+            longest_loss = max(longest_loss, int(value) + 1);
+        else
+            all_lose = false;
+    }
+    if (best_win <= TB_MAX_DIST + 1) // Слишком далекий выигрыш записывается как самый далекий.
+        return uint8_t(min(best_win, int(TB_MAX_DIST)));
+    if (all_lose)
+        return uint8_t(TB_LOSS + min(longest_loss, int(TB_INVALID - TB_LOSS - 1)));
+    return TB_DRAW;
+}
+
+/**
+ * @brief Строит один класс: проходы по всем позициям повторяются, пока значения меняются.
+ * Значения читаются из предыдущего прохода, поэтому потоки не мешают друг другу, а результат не зависит от их числа.
+ * Взятия и превращения ведут в меньшие классы, которые к этому моменту уже построены.
+ */
+vector<uint8_t> build_class(const TBMaterial& m, const unsigned threads)
+{
+    const uint64_t size = m.size();
+    vector<uint8_t> cur(size, TB_DRAW), next(size);
+    for (int pass = 0;; ++pass)
+    {
+        atomic<bool> changed(false);
+        vector<thread> pool;
+        for (unsigned t = 0; t < threads; ++t)
+        {
+            pool.emplace_back([&, t]() {
+                bool local_changed = false;
+                for (uint64_t i = t; i < size; i += threads)
+                {
+                    Position pos;
+                    bool color;
+                    next[i] = (tb_position(m, i, pos, color) ? solve(m, cur, pos, color) : TB_INVALID);
+                    local_changed = local_changed || next[i] != cur[i];
+                }
+                if (local_changed)
+                    changed = true;
+            });
+        }
+        for (auto& th : pool)
+            th.join();
+        cur.swap(next);
+        if (!changed)
+            break;
+    }
+    return cur;
+}
+
+int main(int argc, char* argv[])
+{
+    const int max_pieces = (argc > 1 ? atoi(argv[1]) : 4);
+    const string path = (argc > 2 ? argv[2] : "tablebase.bin");
+    if (max_pieces < 2 || max_pieces > TB_GEN_MAX_PIECES)
+    {
+        cerr << "max_pieces must be in [2, " << TB_GEN_MAX_PIECES << "]\n";
+        return 1;
+    }
+    const unsigned threads = max(1u, thread::hardware_concurrency());
+
+    // Классы строятся от меньшего числа фигур к большему, а при равном - от меньшего числа шашек:
+    // взятие уменьшает число фигур, превращение - число шашек.
+    vector<TBMaterial> order;
+    for (int wm = 0; wm <= max_pieces; ++wm)
+        for (int wk = 0; wm + wk <= max_pieces; ++wk)
+            for (int bm = 0; wm + wk + bm <= max_pieces; ++bm)
+                for (int bk = 0; wm + wk + bm + bk <= max_pieces; ++bk)
+                    if (wm + wk > 0 && bm + bk > 0)
+                        order.emplace_back(wm, wk, bm, bk);
+    stable_sort(order.begin(), order.end(), [](const TBMaterial& a, const TBMaterial& b) {
+        if (a.pieces() != b.pieces())
+            return a.pieces() < b.pieces();
+        return a.wm + a.bm < b.wm + b.bm;
+    });
+
+    memset(built_index, -1, sizeof(built_index));
+    for (const TBMaterial& m : order)
+    {
+        built.push_back({m, build_class(m, threads)});
+        built_index[m.wm][m.wk][m.bm][m.bk] = int(built.size() - 1);
+        uint64_t wins = 0, losses = 0, draws = 0;
+        for (const uint8_t value : built.back().values)
+        {
+            wins += tb_is_win(value);
+            losses += tb_is_loss(value);
+            draws += (value == TB_DRAW);
+        }
+        cout << int(m.wm) << int(m.wk) << "v" << int(m.bm) << int(m.bk) << ": " << wins << " wins, " << losses
+             << " losses, " << draws << " draws\n";
+    }
+
+    TBHeader header;
+    memcpy(header.magic, "CTB1", 4);
+    header.max_pieces = uint32_t(max_pieces);
+    header.classes = uint32_t(built.size());
+    header.reserved = 0;
+    vector<TBClass> classes(built.size());
+    uint64_t offset = sizeof(header) + classes.size() * sizeof(TBClass);
+    for (size_t i = 0; i < built.size(); ++i)
+    {
+        classes[i].material = built[i].material;
+        classes[i].reserved = 0;
+        classes[i].offset = offset;
+        classes[i].size = built[i].values.size();
+        offset += classes[i].size;
+    }
+    ofstream fout(path, ios_base::binary | ios_base::trunc);
+    fout.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    fout.write(reinterpret_cast<const char*>(classes.data()), classes.size() * sizeof(TBClass));
+    for (const BuiltClass& cls : built)
+        fout.write(reinterpret_cast<const char*>(cls.values.data()), cls.values.size());
+    if (!fout)
+    {
+        cerr << "failed to write " << path << "\n";
+        return 1;
+    }
+    cout << "written " << path << " (" << offset << " bytes)\n";
+    return 0;
+}
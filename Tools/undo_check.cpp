@@ -0,0 +1,136 @@
+// Проверка журнала ходов (Models/UndoLog.h) на случайных партиях.
+// Использование: undo_check [games] [seed]
+// Шаги партии пишутся в журнал так же, как это делает Board::move_piece, а доска после каждого шага
+// запоминается отдельно. Затем сверяются с запомненными досками: восстановление на любом шаге (board_at),
+// отмена всех ходов по одному (undo_turn), их повтор (redo_turn) и новая ветка после отмены части ходов
+// (после нее старые ходы больше не повторяются). Код возврата 1 - найдено расхождение.
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "../Game/MoveGen.h"
+#include "../Models/UndoLog.h"
+
+using namespace std;
+
+typedef vector<vector<POS_T>> Matrix;
+
+// Начальная расстановка, как в Board::make_start_mtx().
+Matrix start_mtx()
+{
+    Matrix mtx(8, vector<POS_T>(8, 0));
+    for (POS_T i = 0; i < 8; ++i)
+        for (POS_T j = 0; j < 8; ++j)
+            if ((i + j) % 2 == 1)
+                mtx[i][j] = (i < 3 ? 2 : (i > 4 ? 1 : 0));
+    return mtx;
+}
+
+/**
+ * @brief Играет случайный ход стороны color: шаги записываются в журнал, доски после шагов - в boards.
+ * @return bool: false, если ходов нет.
+ */
+bool play_turn(Matrix& mtx, const bool color, mt19937& rng, UndoLog& log, vector<Matrix>& boards)
+{
+    const Position pos(mtx);
+    TurnList turns;
+    gen_full_turns(pos, color, turns);
+    if (turns.empty())
+        return false;
+    const full_turn& turn = turns[int(rng() % unsigned(turns.size))];
+    int series = 0;
+    for (const move_code step : turn_path(pos, turn))
+    {
+        // Как Board::move_piece: взятие, превращение, перенос фигуры.
+        const int from = step.from(), to = step.to(), beaten = step.beaten();
+        POS_T captured = 0;
+        if (beaten != -1)
+        {
+            captured = mtx[sq_x(beaten)][sq_y(beaten)];
+            mtx[sq_x(beaten)][sq_y(beaten)] = 0;
+            ++series;
+        }
+        POS_T& piece = mtx[sq_x(from)][sq_y(from)];
+        const bool promoted = (piece == 1 && sq_x(to) == 0) || (piece == 2 && sq_x(to) == 7);
+        if (promoted)
+            piece += 2;
+        mtx[sq_x(to)][sq_y(to)] = piece;
+        piece = 0;
+        log.push(history_step(from, to, beaten, captured, promoted, series), mtx);
+        boards.push_back(mtx);
+    }
+    return true;
+}
+
+int main(int argc, char* argv[])
+{
+    const int games = (argc > 1 ? atoi(argv[1]) : 1000);
+    mt19937 rng(argc > 2 ? unsigned(atoi(argv[2])) : 1u);
+    uint64_t checks = 0, errors = 0;
+    auto check = [&](const bool ok) {
+        ++checks;
+        errors += !ok;
+    };
+
+    for (int g = 0; g < games; ++g)
+    {
+        UndoLog log;
+        Matrix mtx = start_mtx();
+        log.reset(mtx);
+        vector<Matrix> boards{ mtx };   // доска после i шагов
+        vector<size_t> turn_starts;     // число шагов перед каждым ходом
+        bool color = false;
+        for (int t = 0; t < 200; ++t, color = !color)
+        {
+            turn_starts.push_back(log.size());
+            if (!play_turn(mtx, color, rng, log, boards))
+            {
+                turn_starts.pop_back();
+                break;
+            }
+        }
+
+        // Восстановление доски после любого шага.
+        Matrix restored;
+        for (size_t i = 0; i < boards.size(); ++i)
+        {
+            log.board_at(i, restored);
+            check(restored == boards[i]);
+        }
+        // Отмена всех ходов по одному, затем повтор всех.
+        for (size_t t = turn_starts.size(); t-- > 0;)
+        {
+            log.undo_turn(mtx);
+            check(log.size() == turn_starts[t] && mtx == boards[turn_starts[t]]);
+        }
+        for (size_t t = 0; t < turn_starts.size(); ++t)
+        {
+            check(log.redo_turn(mtx));
+            const size_t end = (t + 1 < turn_starts.size() ? turn_starts[t + 1] : boards.size() - 1);
+            check(log.size() == end && mtx == boards[end]);
+        }
+        check(!log.redo_turn(mtx));
+
+        // Новая ветка: отмена части ходов и другие ходы; старое продолжение больше не повторить.
+        if (turn_starts.empty())
+            continue;
+        const size_t keep = rng() % turn_starts.size();
+        for (size_t t = turn_starts.size(); t-- > keep;)
+            log.undo_turn(mtx);
+        boards.resize(turn_starts[keep] + 1);
+        color = (keep % 2 == 1);
+        bool played = false;
+        for (int t = 0; t < 40 && play_turn(mtx, color, rng, log, boards); ++t, color = !color)
+            played = true;
+        if (played)
+            check(!log.redo_turn(mtx));
+        check(log.size() == boards.size() - 1);
+        for (size_t i = 0; i < boards.size(); ++i)
+        {
+            log.board_at(i, restored);
+            check(restored == boards[i]);
+        }
+    }
+    cout << games << " games, " << checks << " checks, " << errors << " errors\n";
+    return errors ? 1 : 0;
+}
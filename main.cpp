@@ -1,9 +1,23 @@
+#include <stdio.h>
+#include <stdexcept>
+
 #include "Game/Game.h"
 
 int main(int argc, char* argv[])
 {
-    Game g;
-    g.play();
+    try
+    {
+        Game g;
+        g.run();
+    }
+    catch (const std::exception& e)
+    {
+        // Игра не запускается (например, неверное значение в settings.json): причина выводится
+        // в консоль и в окно сообщения, журнал в этот момент еще не открыт.
+        fprintf(stderr, "Checkers: %s\n", e.what());
+        SDL_ShowSimpleMessageBox(SDL_MESSAGEBOX_ERROR, "Checkers", e.what(), nullptr);
+        return 1;
+    }
 
     return 0;
 }